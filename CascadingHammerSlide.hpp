@@ -0,0 +1,115 @@
+#pragma once
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "HammerSlide.hpp"
+#include "WindowDriver.hpp"
+
+/*
+ * CascadingHammerSlide computes the same aggregate over several count-based windows of
+ * increasing length (e.g., seconds, minutes, hours). Only the finest level consumes the
+ * raw tuples. Every level cuts its input into panes of one slide and each finished pane
+ * aggregate becomes a single input tuple of the next, coarser level.
+ *
+ * Level i is given as (windowSize, windowSlide) in raw tuples. The size and the slide of
+ * level i must be multiples of the slide of level i - 1, so that a coarser window always
+ * consists of whole panes of the finer one. Level i then stores size_i / slide_(i-1)
+ * partials instead of size_i raw tuples.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) CascadingHammerSlide {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  std::vector<std::pair<int, int>> m_windows;
+  int m_numOfLevels;
+
+  // the finest level works on raw tuples, while all the others work on pane partials
+  WindowDriver<AggrFun, type> m_rawLevel;
+  std::vector<WindowDriver<PartialAggregation<AggrFun>, type>> m_partialLevels;
+
+  // the pane that is currently being aggregated by every level
+  std::vector<aggT> m_paneVal;
+  std::vector<int> m_toPaneEnd;
+  AggrFun m_op;
+
+  CascadingHammerSlide(const std::vector<std::pair<int, int>>& windows)
+      : m_windows(windows),
+        m_numOfLevels((int)windows.size()),
+        m_rawLevel(windows.at(0).first, windows.at(0).second) {
+    for (int i = 1; i < m_numOfLevels; i++) {
+      int finerSlide = m_windows[i - 1].second;
+      if (m_windows[i].first % finerSlide != 0 || m_windows[i].second % finerSlide != 0) {
+        throw std::runtime_error("error: a level must consist of panes of the finer level");
+      }
+      m_partialLevels.emplace_back(m_windows[i].first / finerSlide,
+                                   m_windows[i].second / finerSlide);
+    }
+    m_paneVal.resize(m_numOfLevels);
+    m_toPaneEnd.resize(m_numOfLevels);
+    reset();
+  }
+
+  /*
+   * Inserts vals[start, end) and appends the results of the windows that close within the
+   * batch to results[level], from the finest to the coarsest level.
+   * */
+  inline void process(inT* vals, int start, int end, std::vector<std::vector<outT>>& results) {
+    results.resize(m_numOfLevels);
+    outT res;
+    int pos = start;
+    while (pos < end) {
+      int len = std::min(end - pos, m_toPaneEnd[0]);
+      m_paneVal[0] =
+          m_op.combine(m_paneVal[0], reduce_range<AggrFun, type>(m_op, vals, pos, pos + len));
+      if (m_rawLevel.process(vals, pos, pos + len, &res) > 0) {
+        results[0].push_back(res);
+      }
+      pos += len;
+      m_toPaneEnd[0] -= len;
+      if (m_toPaneEnd[0] == 0) {
+        pane_finished(0, results);
+      }
+    }
+  }
+
+  inline void reset() {
+    m_rawLevel.reset();
+    for (auto& level : m_partialLevels) {
+      level.reset();
+    }
+    for (int i = 0; i < m_numOfLevels; i++) {
+      m_paneVal[i] = m_op.identity;
+      m_toPaneEnd[i] = pane_length(i);
+    }
+  }
+
+  /* helper functions */
+  // a pane of level i is measured in input tuples of level i
+  inline int pane_length(int level) const {
+    return (level == 0) ? m_windows[0].second
+                        : m_windows[level].second / m_windows[level - 1].second;
+  }
+
+  inline void pane_finished(int level, std::vector<std::vector<outT>>& results) {
+    aggT pane = m_paneVal[level];
+    m_paneVal[level] = m_op.identity;
+    m_toPaneEnd[level] = pane_length(level);
+    int next = level + 1;
+    if (next == m_numOfLevels) {
+      return;
+    }
+
+    outT res;
+    if (m_partialLevels[level].process(&pane, 0, 1, &res) > 0) {
+      results[next].push_back(res);
+    }
+    m_paneVal[next] = m_op.combine(m_paneVal[next], pane);
+    if (--m_toPaneEnd[next] == 0) {
+      pane_finished(next, results);
+    }
+  }
+};
@@ -3,6 +3,8 @@
 #include <tbb/cache_aligned_allocator.h>
 #include <cstring>
 
+#include "utils/numa.h"
+
 using namespace std;
 
 template <typename T>
@@ -11,7 +13,7 @@ struct alignas(64) CircularQueue {
   int m_rear;
   size_t m_size;
   size_t m_counter;
-  std::vector<T, tbb::cache_aligned_allocator<T>> m_arr;
+  std::vector<T, NumaAllocator<T>> m_arr;
 
   CircularQueue(size_t size)
       : m_front(-1), m_rear(-1), m_size(size), m_counter(0), m_arr(size){};
@@ -30,7 +32,7 @@ struct alignas(64) CircularQueue {
     m_counter++;
   }
 
-  inline void enqueue_many(T* vals, int start, int end) {
+  inline void enqueue_many(const T* vals, int start, int end) {
     if (m_counter + (end - start) > m_size) {
       throw std::runtime_error("Queue is Full \n");
     }
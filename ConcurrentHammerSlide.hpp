@@ -0,0 +1,108 @@
+#pragma once
+
+#include <thread>
+
+#include "HammerSlide.hpp"
+#include "utils/utils.h"
+
+/*
+ * ConcurrentHammerSlide lets reader threads query the current window aggregate while a
+ * single writer thread keeps inserting, evicting and swapping, without any lock. It wraps a
+ * HammerSlide with a sequence lock: the writer makes the version odd before it changes the
+ * stacks and even again afterwards, and a reader combines the top of the front stack with
+ * the back stack aggregate and retries if the version was odd or has changed meanwhile. The
+ * writer never waits for the readers and pays two stores per operation.
+ *
+ * Readers never swap. While the front stack is empty, the window consists of the back stack
+ * only, so its aggregate is the answer. On x86, stores are not reordered with other stores and
+ * loads are not reordered with other loads, so compiler barriers suffice to order the version
+ * and the stacks.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) ConcurrentHammerSlide {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  static const int SPIN_LIMIT = 1024;
+
+  HammerSlide<AggrFun, type> m_window;
+  AggrFun m_op;
+
+  // read by every query, so it lives on its own cache line
+  alignas(64) VOLATILE long m_version;
+
+  ConcurrentHammerSlide(int windowSize, int windowSlide)
+      : m_window(windowSize, windowSlide), m_version(0) {}
+
+  /* writer */
+  inline void insert(inT val) {
+    begin_write();
+    m_window.insert(val);
+    end_write();
+  }
+
+  inline void insert(inT* vals, int start, int end) {
+    begin_write();
+    m_window.insert(vals, start, end);
+    end_write();
+  }
+
+  inline void evict(int numberOfItems = 1) {
+    begin_write();
+    m_window.evict(numberOfItems);
+    end_write();
+  }
+
+  // may swap, so only the writer calls it
+  inline outT query(bool isSIMD = true) {
+    begin_write();
+    outT result = m_window.query(isSIMD);
+    end_write();
+    return result;
+  }
+
+  inline void reset() {
+    begin_write();
+    m_window.reset();
+    end_write();
+  }
+
+  /* readers */
+  // the aggregate of the window as of the last completed operation of the writer
+  inline outT concurrent_query() const {
+    for (int spins = 0;; spins++) {
+      long version = m_version;
+      COMPILER_BARRIER;
+      if (version & 1) {
+        // the writer may have been preempted on the core of the reader
+        if (spins < SPIN_LIMIT) {
+          PAUSE;
+        } else {
+          std::this_thread::yield();
+        }
+        continue;
+      }
+
+      // a torn read is discarded below, but it must stay within the bounds of the front stack
+      int ostackSize = m_window.m_ostackSize;
+      const aggT* ostackVal = m_window.m_ostackVal.data();
+      int istackSize = m_window.m_istackSize;
+      aggT front = m_op.identity;
+      if (ostackSize > 0 && ostackSize <= m_window.m_windowSize) {
+        front = ostackVal[ostackSize - 1];
+      }
+      aggT back = (istackSize == 0) ? m_op.identity : m_window.m_istackVal;
+
+      COMPILER_BARRIER;
+      if (m_version == version) {
+        return m_op.lower(m_op.combine(front, back));
+      }
+    }
+  }
+
+  /* helper functions */
+  inline void begin_write() { COMPILER_NO_REORDER(m_version = m_version + 1); }
+
+  inline void end_write() { COMPILER_NO_REORDER(m_version = m_version + 1); }
+};
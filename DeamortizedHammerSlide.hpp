@@ -0,0 +1,177 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include "CircularQueue.hpp"
+#include "HammerSlide.hpp"
+
+/*
+ * DeamortizedHammerSlide spreads the swap of the Two-Stacks algorithm over the insert and
+ * evict operations, so that every operation performs a bounded amount of work instead of
+ * paying for a whole swap once per window.
+ *
+ * The tuples of the circular buffer are split into three consecutive segments: the front
+ * F, the middle M and the back C. An aggregate array parallel to the circular buffer holds
+ * for every tuple of F the aggregate from that tuple to the end of F, while C only keeps a
+ * running aggregate. As soon as C becomes larger than F, it is sealed as M and two phases
+ * run incrementally, STEPS tuples per operation: the rebuild computes the suffix aggregates
+ * of M and the fixup combines the aggregate of M into the entries of F. Afterwards F and M
+ * form the new front. Because C is sealed when |C| = |F| + 1, both phases finish before F
+ * runs out of tuples.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) DeamortizedHammerSlide {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  enum Phase { IDLE, REBUILD, FIXUP };
+  static const int STEPS = 3;
+
+  int m_windowSize;
+  Phase m_phase;
+
+  // tuple sequence numbers where F, M and C start and where the next tuple goes
+  long m_front;
+  long m_middle;
+  long m_back;
+  long m_end;
+
+  // the next tuple of M to rebuild and of F to fix up, moving from newer to older tuples
+  long m_rebuildPtr;
+  long m_fixupPtr;
+  aggT m_rebuildVal;
+
+  aggT m_middleVal;
+  aggT m_backVal;
+
+  // a queue that holds the actual data
+  CircularQueue<inT> m_queue;
+  // the suffix aggregates of the tuples in F and M
+  std::vector<aggT, tbb::cache_aligned_allocator<aggT>> m_aggs;
+  AggrFun m_op;
+
+  DeamortizedHammerSlide(int windowSize)
+      : m_windowSize(windowSize), m_queue(windowSize), m_aggs(windowSize) {
+    reset();
+  }
+
+  inline void insert(inT val) {
+    m_queue.enqueue(val);
+    m_backVal = m_op.combine(m_backVal, m_op.lift(val));
+    m_end++;
+    step(STEPS);
+  }
+
+  inline void insert(inT* vals, int start, int end) {
+    while (start < end) {
+      // insert the tuples in bulk up to the next point where the state changes phase
+      int numOfVals = end - start;
+      if (m_phase == IDLE) {
+        numOfVals = std::min(numOfVals, (int)((m_middle - m_front) - (m_end - m_back) + 1));
+      } else {
+        numOfVals = std::min(numOfVals, (int)((remaining_work() + STEPS - 1) / STEPS));
+      }
+      numOfVals = std::max(numOfVals, 1);
+
+      m_queue.enqueue_many(vals, start, start + numOfVals);
+      m_backVal = m_op.combine(m_backVal,
+                               reduce_range<AggrFun, type>(m_op, vals, start, start + numOfVals));
+      m_end += numOfVals;
+      step(STEPS * numOfVals);
+      start += numOfVals;
+    }
+  }
+
+  inline void evict(int numberOfItems = 1) {
+    for (int i = 0; i < numberOfItems; i++) {
+      if (m_front == m_end) {
+        throw std::runtime_error("error: the window is empty");
+      }
+      if (m_front == m_middle) {
+        // F ran out of tuples before the incremental phases completed
+        if (m_phase == IDLE) seal();
+        step(remaining_work());
+      }
+      m_front++;
+      m_queue.dequeue_many(1);
+      step(STEPS);
+    }
+  }
+
+  inline outT query() {
+    aggT frontVal = m_op.identity;
+    if (m_front < m_middle) {
+      frontVal = m_aggs[position(m_front)];
+      // entries of F that have not been fixed up yet miss the aggregate of M
+      if (m_phase == FIXUP && m_front <= m_fixupPtr) {
+        frontVal = m_op.combine(frontVal, m_middleVal);
+      }
+    }
+    if (m_phase == REBUILD) {
+      frontVal = m_op.combine(frontVal, m_middleVal);
+    }
+    return m_op.lower(m_op.combine(frontVal, m_backVal));
+  }
+
+  inline void reset() {
+    m_phase = IDLE;
+    m_front = m_middle = m_back = m_end = 0;
+    m_rebuildPtr = m_fixupPtr = -1;
+    m_rebuildVal = m_middleVal = m_backVal = m_op.identity;
+    m_queue.reset();
+  }
+
+  /* helper functions */
+  inline int position(long seq) const { return (int)(seq % m_windowSize); }
+
+  inline long remaining_work() const {
+    switch (m_phase) {
+      case REBUILD:
+        return (m_rebuildPtr - m_middle + 1) + (m_middle - m_front);
+      case FIXUP:
+        return std::max(m_fixupPtr - m_front + 1, 0L);
+      case IDLE:
+      default:
+        return 0;
+    }
+  }
+
+  inline void seal() {
+    m_back = m_end;
+    m_middleVal = m_backVal;
+    m_backVal = m_op.identity;
+    m_rebuildPtr = m_back - 1;
+    m_rebuildVal = m_op.identity;
+    m_phase = REBUILD;
+  }
+
+  inline void step(long steps) {
+    for (; steps > 0 && m_phase != IDLE; steps--) {
+      if (m_phase == REBUILD) {
+        int pos = position(m_rebuildPtr);
+        m_rebuildVal = m_op.combine(m_op.lift(m_queue.m_arr[pos]), m_rebuildVal);
+        m_aggs[pos] = m_rebuildVal;
+        if (--m_rebuildPtr < m_middle) {
+          m_phase = FIXUP;
+          m_fixupPtr = m_middle - 1;
+        }
+      } else if (m_fixupPtr >= m_front) {
+        int pos = position(m_fixupPtr--);
+        m_aggs[pos] = m_op.combine(m_aggs[pos], m_middleVal);
+      }
+
+      if (m_phase == FIXUP && m_fixupPtr < m_front) {
+        // F and M form the new front
+        m_middle = m_back;
+        m_phase = IDLE;
+      }
+    }
+
+    if (m_phase == IDLE && (m_end - m_back) > (m_middle - m_front)) {
+      seal();
+      step(1);
+    }
+  }
+};
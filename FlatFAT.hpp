@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include <tbb/cache_aligned_allocator.h>
+
+#include "utils/numa.h"
+
+/*
+ * FlatFAT is a complete binary tree of partial aggregates stored in an array, where the
+ * leaves correspond to the slots of a circular buffer. Updating a range of slots and
+ * querying the aggregate of a range both take O(log n) time (plus the length of the updated
+ * range), while the order of the tuples is preserved for non-commutative functions.
+ * */
+template <typename AggrFun>
+struct alignas(64) FlatFAT {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+
+  int m_size;
+  int m_leaves;
+  std::vector<aggT, NumaAllocator<aggT>> m_tree;
+  AggrFun m_op;
+
+  FlatFAT(int size, const NumaAllocator<aggT>& allocator = NumaAllocator<aggT>())
+      : m_size(size), m_leaves(1), m_tree(allocator) {
+    while (m_leaves < size) m_leaves *= 2;
+    m_tree.resize(2 * m_leaves, m_op.identity);
+  }
+
+  // copies the slots [start, end) of the buffer into the leaves and repairs their ancestors
+  inline void update(const inT* vals, int start, int end) {
+    if (start >= end) {
+      return;
+    }
+    for (int i = start; i < end; i++) {
+      m_tree[m_leaves + i] = m_op.lift(vals[i]);
+    }
+    repair(start, end);
+  }
+
+  // replaces the partial of a single slot, e.g. with the identity to remove a tuple
+  inline void set(int pos, aggT value) {
+    m_tree[m_leaves + pos] = value;
+    repair(pos, pos + 1);
+  }
+
+  // the aggregate of the slots [start, end)
+  inline aggT query(int start, int end) const {
+    aggT left = m_op.identity;
+    aggT right = m_op.identity;
+    for (int lo = m_leaves + start, hi = m_leaves + end; lo < hi; lo /= 2, hi /= 2) {
+      if (lo & 1) left = m_op.combine(left, m_tree[lo++]);
+      if (hi & 1) right = m_op.combine(m_tree[--hi], right);
+    }
+    return m_op.combine(left, right);
+  }
+
+  /* helper functions */
+  // recomputes the ancestors of the leaves [start, end)
+  inline void repair(int start, int end) {
+    int lo = (m_leaves + start) / 2;
+    int hi = (m_leaves + end - 1) / 2;
+    for (; lo > 0; lo /= 2, hi /= 2) {
+      for (int node = lo; node <= hi; node++) {
+        m_tree[node] = m_op.combine(m_tree[2 * node], m_tree[2 * node + 1]);
+      }
+    }
+  }
+};
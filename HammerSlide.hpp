@@ -1,13 +1,23 @@
 #pragma once
 
+#include <algorithm>
 #include <climits>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include "emmintrin.h"
 #include "immintrin.h"
 
 #include "CircularQueue.hpp"
+#include "FlatFAT.hpp"
 #include "utils/SystemConf.h"
+#include "utils/numa.h"
+#include "utils/utils.h"
 
 typedef union {
   __m256i v;
@@ -19,12 +29,81 @@ typedef union {
   int a[4];
 } U128i;
 
+// the SIMD kernels are only implemented for MIN and SUM over ints
+template <typename AggrFun, AggregationType type>
+constexpr bool is_simd_supported() {
+  return (type == MIN || type == SUM) && std::is_same<typename AggrFun::In, int>::value &&
+         std::is_same<typename AggrFun::Partial, int>::value;
+}
+
+/*
+ * Aggregates vals[start, end) into a single partial. When a SIMD kernel exists, the
+ * 32-byte aligned part of the range is aggregated with 256-bit vectors.
+ * */
+template <typename AggrFun, AggregationType type>
+inline typename AggrFun::Partial reduce_range(const AggrFun& op,
+                                              const typename AggrFun::In* vals, int start,
+                                              int end) {
+  typename AggrFun::Partial value = op.identity;
+  if constexpr (is_simd_supported<AggrFun, type>()) {
+    if (end - start >= 16) {  // skip vectorization for less than 16 integers
+      while (reinterpret_cast<uintptr_t>(vals + start) % 32 != 0) {
+        value = op.combine(value, op.lift(vals[start++]));
+      }
+      int n = (end - start) / 8;
+      const __m256i* f4 = (const __m256i*)(vals + start);
+      __m256i tempVal = _mm256_set1_epi32(op.identity);
+      for (int i = 0; i < n; i++) {
+        tempVal = (type == MIN) ? _mm256_min_epi32(tempVal, _mm256_load_si256(f4 + i))
+                                : _mm256_add_epi32(tempVal, _mm256_load_si256(f4 + i));
+      }
+      const U256i r = {tempVal};
+      for (int i = 0; i < 8; i++) {
+        value = op.combine(value, r.a[i]);
+      }
+      start += n * 8;
+    }
+  }
+  for (int i = start; i < end; i++) {
+    value = op.combine(value, op.lift(vals[i]));
+  }
+  return value;
+}
+
+/*
+ * Adapts an aggregation function so that its partial aggregates can be inserted as input
+ * tuples, e.g. when the pane partials of one window feed another window.
+ * */
+template <typename AggrFun>
+struct PartialAggregation {
+  typedef typename AggrFun::Partial In;
+  typedef typename AggrFun::Partial Partial;
+  typedef typename AggrFun::Out Out;
+
+  AggrFun m_op;
+
+  Out lower(const Partial& c) const { return m_op.lower(c); }
+
+  Partial lift(const In& v) const { return v; }
+
+  Partial combine(const Partial& a, const Partial& b) const { return m_op.combine(a, b); }
+
+  static const Partial identity;
+};
+
+template <typename AggrFun>
+const typename PartialAggregation<AggrFun>::Partial PartialAggregation<AggrFun>::identity =
+    AggrFun::identity;
+
 template <typename AggrFun, AggregationType type>
 struct alignas(64) HammerSlide {
   typedef typename AggrFun::In inT;
   typedef typename AggrFun::Partial aggT;
   typedef typename AggrFun::Out outT;
 
+  // the minimum number of tuples that a task of the parallel swap scans
+  static const int PARALLEL_SWAP_CHUNK = 16 * 1024;
+
   int m_windowSize;
   int m_windowSlide;
   int m_windowPane;
@@ -38,15 +117,41 @@ struct alignas(64) HammerSlide {
   int m_ostackSize;
   int m_ostackPtr;
   aggT m_istackVal;
+  // the distance between the materialized entries of the output stack
+  int m_ostackStride;
+  // back stacks of at least this many tuples are swapped in parallel, 0 disables it; copies of
+  // the window share the arena
+  int m_parallelSwapSize;
+  std::shared_ptr<tbb::task_arena> m_swapArena;
+  std::shared_ptr<PinningObserver> m_swapObserver;
+
+  // a back stack that has been sealed by prepare() and the next front stack that is being
+  // built from it incrementally
+  int m_sealedSize;
+  int m_sealedPtr;
+  aggT m_sealedVal;
+  int m_shadowSize;
+  std::vector<aggT, NumaAllocator<aggT>> m_shadowVal;
 
   // a queue that holds the actual data
   CircularQueue<inT> m_queue;
   // a variable with the aggT of the input stack
   aggT m_runningValue;
   // a vector with the aggTs of the output stack
-  std::vector<aggT, tbb::cache_aligned_allocator<aggT>> m_ostackVal;
+  std::vector<aggT, NumaAllocator<aggT>> m_ostackVal;
   AggrFun m_op;
 
+  // a tree over the circular buffer for range queries, synchronized lazily with the tuples
+  // inserted since the last range query. The tuples are numbered in insertion order, and the
+  // number of the oldest one is the number of evicted tuples, so that insertions do no extra
+  // bookkeeping.
+  FlatFAT<AggrFun> m_rangeTree;
+  long m_evicted;
+  long m_synced;
+  // the stack aggregates are stale while the window contains a tuple that was retracted or
+  // updated, i.e., a tuple with a sequence number below m_dirtyUntil
+  long m_dirtyUntil;
+
   HammerSlide(int windowSize, int windowSlide)
       : m_windowSize(windowSize),
         m_windowSlide(windowSlide),
@@ -55,8 +160,16 @@ struct alignas(64) HammerSlide {
         m_istackPtr(-1),
         m_ostackSize(0),
         m_ostackPtr(-1),
+        m_ostackStride(1),
+        m_parallelSwapSize(0),
+        m_sealedSize(0),
+        m_shadowSize(0),
         m_queue(windowSize),
-        m_ostackVal(windowSize) {
+        m_ostackVal(windowSize),
+        m_rangeTree(0),
+        m_evicted(0),
+        m_synced(0),
+        m_dirtyUntil(0) {
     m_windowPane = m_windowSize / m_windowSlide;  // fix: assume that the slide is a multiple of the size
     m_currentWindowPane = 0;
     m_countBasedCounter = 0;
@@ -152,19 +265,28 @@ struct alignas(64) HammerSlide {
     m_ostackPtr += numberOfItems;
     m_ostackSize -= numberOfItems;
     m_capacity -= numberOfItems;
+    m_evicted += numberOfItems;
     m_queue.dequeue_many(numberOfItems);
   }
 
   inline outT query(bool isSIMD = true) {
+    // todo: fix aggregates like avg
+    return m_op.lower(query_partial(isSIMD));
+  }
+
+  // the aggregate of the window before it is lowered to the output type
+  inline aggT query_partial(bool isSIMD = true) {
     if (m_ostackSize == 0) {
       swap(isSIMD);
     }
+    // a prepared back stack or a modified tuple take the slow path
+    if (m_sealedSize > 0 || m_dirtyUntil > m_evicted) {
+      return query_extended();
+    }
 
     aggT temp1 = m_ostackVal[m_ostackSize - 1];
     aggT temp2 = (m_istackSize == 0) ? m_op.identity : m_istackVal;
-
-    // todo: fix aggregates like avg
-    return m_op.lower(m_op.combine(temp1, temp2));
+    return m_op.combine(temp1, temp2);
   }
 
   inline void reset() {
@@ -173,11 +295,242 @@ struct alignas(64) HammerSlide {
     m_istackPtr = -1;
     m_ostackSize = 0;
     m_ostackPtr = -1;
+    m_sealedSize = 0;
+    m_shadowSize = 0;
+    m_evicted = 0;
+    m_synced = 0;
+    m_dirtyUntil = 0;
     m_queue.reset();
   }
 
+  /*
+   * Returns the aggregate of the k most recent tuples. When the range covers the back stack
+   * and ends at a materialized entry of the output stack, it takes O(1) time. Otherwise, the
+   * range tree is brought up to date and queried in O(log n) time.
+   * */
+  inline outT query_range(int k) {
+    if (k <= 0 || k > (int)m_capacity) {
+      throw std::runtime_error("error: the range exceeds the window");
+    }
+    if (!is_dirty()) {
+      int backSize = m_istackSize + m_sealedSize;
+      aggT back = (m_istackSize == 0) ? m_op.identity : m_istackVal;
+      if (m_sealedSize > 0) {
+        back = m_op.combine(m_sealedVal, back);
+      }
+      int frontSize = k - backSize;
+      if (frontSize == 0) {
+        return m_op.lower(back);
+      }
+      if (frontSize > 0 && frontSize % m_ostackStride == 0) {
+        return m_op.lower(m_op.combine(m_ostackVal[frontSize - 1], back));
+      }
+    }
+    return m_op.lower(range_aggregate(window_position((int)m_capacity - k), k));
+  }
+
+  // the aggregate of the tuples [from, to) of the window, counting from the oldest one
+  inline outT query_range(int from, int to) {
+    if (from < 0 || from >= to || to > (int)m_capacity) {
+      throw std::runtime_error("error: the range exceeds the window");
+    }
+    if (to == (int)m_capacity) {
+      return query_range(to - from);
+    }
+    return m_op.lower(range_aggregate(window_position(from), to - from));
+  }
+
+  /*
+   * Removes the tuple at the given offset from the oldest tuple of the window, e.g. a
+   * duplicate. The tuple keeps its slot, so the following FIFO evictions are not affected,
+   * but it no longer contributes to the results. Retractions and updates take O(log n)
+   * time in the range tree. Queries use the tree until the modified tuple is evicted, after
+   * which the stack aggregates are valid again.
+   * */
+  inline void retract(int offset) {
+    int pos = modify(offset);
+    m_rangeTree.set(pos, m_op.identity);
+  }
+
+  // replaces the tuple at the given offset from the oldest tuple of the window
+  inline void update(int offset, inT val) {
+    int pos = modify(offset);
+    m_queue.m_arr[pos] = val;
+    m_rangeTree.set(pos, m_op.lift(val));
+  }
+
+  /*
+   * Swaps back stacks of at least minSize tuples with a parallel suffix scan over a TBB arena
+   * of numOfThreads threads, which shortens the stall of a query on a huge window. The front
+   * stack has the same layout as after the sequential swap of the same kind. With pinning, the
+   * workers of the arena are placed next to the thread that queries. A minSize of 0 disables
+   * it.
+   * */
+  inline void set_parallel_swap(int minSize, int numOfThreads = tbb::task_arena::automatic,
+                                bool pin = false) {
+    m_parallelSwapSize = minSize;
+    m_swapObserver.reset();
+    m_swapArena.reset();
+    if (minSize > 0) {
+      m_swapArena = std::make_shared<tbb::task_arena>(numOfThreads);
+      if (pin) {
+        m_swapObserver = std::make_shared<PinningObserver>(*m_swapArena);
+      }
+    }
+  }
+
+  /*
+   * Moves the circular buffer and the stack arrays to memory bound to a NUMA node, by default
+   * the one of the calling thread, e.g. after a worker has been pinned to its core. Arrays that
+   * are allocated later stay on the node. Returns false if the kernel does not support it.
+   * */
+  inline bool bind_to_node(int node = current_numa_node()) {
+    bool bound = move_to_numa_node(m_queue.m_arr, node);
+    bound &= move_to_numa_node(m_ostackVal, node);
+    bound &= move_to_numa_node(m_shadowVal, node);
+    bound &= move_to_numa_node(m_rangeTree.m_tree, node);
+    return bound;
+  }
+
+  /*
+   * Builds up to budget entries of the next front stack, e.g. while the pipeline is idle.
+   * The first call seals the current back stack and later insertions start a new one. Once
+   * the front stack runs empty, the swap only flips the prepared array.
+   * */
+  inline void prepare(int budget) {
+    if (m_sealedSize == 0) {
+      if (m_istackSize == 0) return;
+      m_sealedSize = m_istackSize;
+      m_sealedPtr = m_istackPtr;
+      m_sealedVal = m_istackVal;
+      m_shadowSize = 0;
+      m_istackSize = 0;
+      m_istackPtr = -1;
+      if (m_shadowVal.empty()) m_shadowVal.resize(m_windowSize);
+    }
+
+    int limit = std::min(m_sealedSize, m_shadowSize + budget);
+    int inputIndex = m_sealedPtr - m_shadowSize;
+    if (inputIndex < 0) inputIndex += m_queue.m_size;
+    aggT tempValue = (m_shadowSize == 0) ? m_op.identity : m_shadowVal[m_shadowSize - 1];
+    for (; m_shadowSize < limit; m_shadowSize++) {
+      tempValue = m_op.combine(m_op.lift(m_queue.m_arr[inputIndex]), tempValue);
+      m_shadowVal[m_shadowSize] = tempValue;
+      inputIndex--;
+      if (inputIndex < 0) inputIndex = m_queue.m_size - 1;
+    }
+  }
+
+  /*
+   * Computes the results of the next windows without changing the state, assuming that the
+   * slides batch[i * windowSlide, (i + 1) * windowSlide) are inserted one by one and a slide
+   * is evicted after each result. This is possible while the window misses exactly one slide
+   * and the front stack covers the upcoming slides, because every result is then a front
+   * stack entry combined with the back stack and a prefix of the batch. For int MIN and SUM,
+   * the front stack entries are gathered and combined eight results at a time, unless isSIMD
+   * is false. Returns the number of results written, at most numOfSlides.
+   * */
+  inline int lookahead(const inT* batch, int numOfSlides, outT* results,
+                       bool isSIMD = true) const {
+    if ((int)m_capacity != m_windowSize - m_windowSlide || m_ostackSize % m_ostackStride != 0 ||
+        is_dirty()) {
+      return 0;
+    }
+    numOfSlides = std::min(numOfSlides, m_ostackSize / m_windowSlide);
+
+    // the prefix aggregates of the batch combined with the back stack
+    aggT back = (m_istackSize == 0) ? m_op.identity : m_istackVal;
+    if (m_sealedSize > 0) {
+      back = m_op.combine(m_sealedVal, back);
+    }
+    if constexpr (is_simd_supported<AggrFun, type>() && std::is_same<outT, int>::value) {
+      if (isSIMD) {
+        for (int i = 0; i < numOfSlides; i++) {
+          int paneStart = i * m_windowSlide;
+          int paneEnd = paneStart + m_windowSlide;
+          back = m_op.combine(back, reduce_range<AggrFun, type>(m_op, batch, paneStart, paneEnd));
+          results[i] = back;
+        }
+
+        // the front stack entries are windowSlide apart, starting from the oldest tuple
+        const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                 _mm256_set1_epi32(m_windowSlide));
+        int i = 0;
+        for (; i + 8 <= numOfSlides; i += 8) {
+          __m256i idx = _mm256_sub_epi32(
+              _mm256_set1_epi32(m_ostackSize - i * m_windowSlide - 1), lanes);
+          __m256i front = _mm256_i32gather_epi32((const int*)m_ostackVal.data(), idx, 4);
+          __m256i prefix = _mm256_loadu_si256((const __m256i*)(results + i));
+          __m256i res = (type == MIN) ? _mm256_min_epi32(front, prefix)
+                                      : _mm256_add_epi32(front, prefix);
+          _mm256_storeu_si256((__m256i*)(results + i), res);
+        }
+        for (; i < numOfSlides; i++) {
+          results[i] = m_op.combine(m_ostackVal[m_ostackSize - i * m_windowSlide - 1], results[i]);
+        }
+        return numOfSlides;
+      }
+    }
+    for (int i = 0; i < numOfSlides; i++) {
+      int paneStart = i * m_windowSlide;
+      int paneEnd = paneStart + m_windowSlide;
+      back = m_op.combine(back, reduce_range<AggrFun, type>(m_op, batch, paneStart, paneEnd));
+      aggT front = m_ostackVal[m_ostackSize - i * m_windowSlide - 1];
+      results[i] = m_op.lower(m_op.combine(front, back));
+    }
+    return numOfSlides;
+  }
+
+  /*
+   * Ingests a batch of n tuples and writes the result of every window that closes within it,
+   * evicting one slide after each result. The output buffer must have room for
+   * n / windowSlide + 1 results. Returns the number of results written.
+   *
+   * Whenever lookahead() can answer the upcoming slides, their insertions and evictions are
+   * applied in bulk afterwards, without a query and an eviction per slide.
+   * */
+  inline size_t process(const inT* batch, size_t n, outT* results) {
+    bool isSIMD = is_simd_supported<AggrFun, type>() && (m_windowSize % m_windowSlide == 0) &&
+                  (m_windowSlide % 8 == 0);
+    size_t numOfResults = 0;
+    size_t pos = 0;
+    while (pos < n) {
+      int numOfSlides =
+          lookahead(batch + pos, (int)((n - pos) / m_windowSlide), results + numOfResults);
+      if (numOfSlides > 0) {
+        int len = numOfSlides * m_windowSlide;
+        aggT panes = reduce_range<AggrFun, type>(m_op, batch, (int)pos, (int)pos + len);
+        evict(len);
+        m_queue.enqueue_many(batch, (int)pos, (int)pos + len);
+        m_istackVal = (m_istackSize == 0) ? panes : m_op.combine(panes, m_istackVal);
+        m_capacity += len;
+        m_istackSize += len;
+        m_istackPtr = m_queue.m_rear;
+        numOfResults += numOfSlides;
+        pos += len;
+        continue;
+      }
+
+      int len = std::min((int)(n - pos), m_windowSize - (int)m_capacity);
+      insert_simple_range(batch, (int)pos, (int)pos + len);
+      pos += len;
+      if ((int)m_capacity == m_windowSize) {
+        results[numOfResults++] = query(isSIMD);
+        for (int numberOfItems = m_windowSlide; numberOfItems > 0;) {
+          if (m_ostackSize == 0) {
+            swap(isSIMD);
+          }
+          int items = std::min(numberOfItems, m_ostackSize);
+          evict(items);
+          numberOfItems -= items;
+        }
+      }
+    }
+    return numOfResults;
+  }
+
   /* helper functions */
-  inline void insert_simple_range(inT* vals, int start, int end) {
+  inline void insert_simple_range(const inT* vals, int start, int end) {
     auto numOfVals = end - start;
     aggT tempValue = (m_istackSize == 0) ? m_op.identity : m_istackVal;
     for (int i = start; i < end; i++) {
@@ -194,21 +547,37 @@ struct alignas(64) HammerSlide {
    * todo: the swap function has been tested with window sizes/slides that are a power of two.
    * */
   inline void swap(bool isSIMD = true) {
+    if (m_sealedSize > 0) {
+      flip();
+      return;
+    }
+
     int outputIndex = 0;
     int inputIndex = m_istackPtr;
     int limit = m_istackSize;
     int tempRear = m_queue.m_rear;
     int queueSize = m_queue.m_size;
 
+    // the SIMD path expects a back stack of whole slides that ends at a slide boundary
+    bool isAligned =
+        (m_istackSize % m_windowSlide == 0) && ((m_istackPtr + 1) % m_windowSlide == 0);
+
     aggT tempValue = m_op.identity;
-    if (m_windowSlide < 16 || !isSIMD) {  // skip vectorization for less than 16 integers
+    if (m_parallelSwapSize > 0 && limit >= m_parallelSwapSize) {
+      bool isStrided = m_windowSlide >= 16 && isSIMD && isAligned;
+      m_swapArena->execute([&] { parallel_scan(limit, isStrided); });
+    } else if (m_windowSlide < 16 || !isSIMD || !isAligned) {
+      // skip vectorization for less than 16 integers
+      m_ostackStride = 1;
       for (outputIndex = 0; outputIndex < limit; outputIndex++) {
         auto tempTuple = m_queue.m_arr[inputIndex];
         tempValue = m_op.combine(tempTuple, tempValue);
         m_ostackVal[outputIndex] = tempValue;
         inputIndex--;
+        if (inputIndex < 0) inputIndex = queueSize - 1;
       }
     } else {  // SIMD path
+      m_ostackStride = m_windowSlide;
       // The logic of this code is that we start iterating the first stack
       // stored in the circular buffer backwards based on the window slide
       // and compute the aggregate values. We round the limits of each window
@@ -221,6 +590,7 @@ struct alignas(64) HammerSlide {
         // int tempQueueFront = (tempRear - m_istackSize + 1 + tempSize) % queueSize;
         // int tempQueueRear = (tempQueueFront + m_windowSlide - 1) % queueSize;
         int tempQueueRear = tempRear - tempSize;
+        if (tempQueueRear < 0) tempQueueRear += queueSize;
         int tempQueueFront = tempQueueRear - m_windowSlide + 1;
         if (tempQueueRear >= queueSize || tempQueueFront >= queueSize) {
           throw std::runtime_error("error: wrong queue indexes");
@@ -365,4 +735,142 @@ struct alignas(64) HammerSlide {
       m_ostackPtr = (m_queue.m_rear + m_ostackSize) % (m_queue.m_size - 1);
     m_istackPtr = -1;
   }
-};
\ No newline at end of file
+
+  /*
+   * Fills the first limit entries of the front stack from the back stack in three steps: the
+   * chunks of the back stack are reduced in parallel, the carry of every chunk (i.e., the
+   * aggregate of the newer chunks) is computed sequentially, and the chunks are scanned in
+   * parallel starting from their carry. When strided, the chunks consist of whole slides and
+   * only the last entry of every slide is materialized, from a vectorized reduction of the
+   * slide, as in the SIMD swap.
+   * */
+  inline void parallel_scan(int limit, bool isStrided) {
+    m_ostackStride = isStrided ? m_windowSlide : 1;
+    // a single chunk needs no reduction, which saves a pass without parallelism
+    int concurrency = tbb::this_task_arena::max_concurrency();
+    int numOfChunks = (concurrency == 1)
+                          ? 1
+                          : std::max(1, std::min(limit / PARALLEL_SWAP_CHUNK, 4 * concurrency));
+    int chunkSize = (limit + numOfChunks - 1) / numOfChunks;
+    chunkSize = (chunkSize + m_ostackStride - 1) / m_ostackStride * m_ostackStride;
+    numOfChunks = (limit + chunkSize - 1) / chunkSize;
+    std::vector<aggT> carry(numOfChunks, m_op.identity);
+
+    tbb::parallel_for(1, numOfChunks, [&](int c) {
+      carry[c] = reduce_back_stack((c - 1) * chunkSize, c * chunkSize);
+    });
+    for (int c = 2; c < numOfChunks; c++) {
+      carry[c] = m_op.combine(carry[c], carry[c - 1]);
+    }
+
+    tbb::parallel_for(0, numOfChunks, [&](int c) {
+      int lo = c * chunkSize;
+      int hi = std::min(limit, lo + chunkSize);
+      aggT tempValue = carry[c];
+      if (isStrided) {
+        for (int i = lo; i < hi; i += m_windowSlide) {
+          tempValue = m_op.combine(reduce_back_stack(i, i + m_windowSlide), tempValue);
+          m_ostackVal[i + m_windowSlide - 1] = tempValue;
+        }
+        return;
+      }
+      int queueSize = (int)m_queue.m_size;
+      int inputIndex = m_istackPtr - lo;
+      if (inputIndex < 0) inputIndex += queueSize;
+      for (int i = lo; i < hi; i++) {
+        tempValue = m_op.combine(m_op.lift(m_queue.m_arr[inputIndex]), tempValue);
+        m_ostackVal[i] = tempValue;
+        inputIndex = (inputIndex == 0) ? queueSize - 1 : inputIndex - 1;
+      }
+    });
+  }
+
+  // the aggregate of the back stack tuples that become the front stack entries [lo, hi), i.e.,
+  // the buffer positions from m_istackPtr - hi + 1 to m_istackPtr - lo, which wrap around the
+  // end at most once
+  inline aggT reduce_back_stack(int lo, int hi) const {
+    int queueSize = (int)m_queue.m_size;
+    int first = m_istackPtr - hi + 1;
+    if (first < 0) first += queueSize;
+    const inT* vals = m_queue.m_arr.data();
+    if (first + (hi - lo) <= queueSize) {
+      return reduce_range<AggrFun, type>(m_op, vals, first, first + hi - lo);
+    }
+    return m_op.combine(reduce_range<AggrFun, type>(m_op, vals, first, queueSize),
+                        reduce_range<AggrFun, type>(m_op, vals, 0, first + hi - lo - queueSize));
+  }
+
+  // makes the front stack prepared by prepare() the current one
+  inline void flip() {
+    prepare(m_sealedSize);
+    std::swap(m_ostackVal, m_shadowVal);
+    m_ostackSize = m_sealedSize;
+    m_ostackStride = 1;
+    m_ostackPtr = m_sealedPtr - m_sealedSize + 1;
+    if (m_ostackPtr < 0) m_ostackPtr += m_queue.m_size;
+    m_sealedSize = 0;
+    m_shadowSize = 0;
+  }
+
+  // the aggregate of len tuples starting at position start of the circular buffer
+  inline aggT range_aggregate(int start, int len) {
+    sync_range_tree();
+    int queueSize = (int)m_queue.m_size;
+    if (start + len <= queueSize) {
+      return m_rangeTree.query(start, start + len);
+    }
+    return m_op.combine(m_rangeTree.query(start, queueSize),
+                        m_rangeTree.query(0, start + len - queueSize));
+  }
+
+  inline void sync_range_tree() {
+    int queueSize = (int)m_queue.m_size;
+    if (m_rangeTree.m_size != queueSize) {
+      m_rangeTree = FlatFAT<AggrFun>(queueSize, m_rangeTree.m_tree.get_allocator());
+      m_synced = 0;
+    }
+    long inserted = m_evicted + (long)m_capacity;
+    long numOfNew = inserted - m_synced;
+    const inT* vals = m_queue.m_arr.data();
+    if (numOfNew >= queueSize || m_synced == 0) {
+      m_rangeTree.update(vals, 0, queueSize);
+    } else if (numOfNew > 0) {
+      int end = m_queue.m_rear + 1;
+      int start = end - (int)numOfNew;
+      if (start < 0) {
+        m_rangeTree.update(vals, start + queueSize, queueSize);
+        start = 0;
+      }
+      m_rangeTree.update(vals, start, end);
+    }
+    m_synced = inserted;
+  }
+
+  // the position in the circular buffer of the tuple at the given offset from the oldest one
+  inline int window_position(int offset) const {
+    int pos = m_queue.m_rear - (int)m_capacity + 1 + offset;
+    return (pos < 0) ? pos + (int)m_queue.m_size : pos;
+  }
+
+  inline bool is_dirty() const { return m_evicted < m_dirtyUntil; }
+
+  // the aggregate of the window while a back stack is prepared or a tuple is modified
+  inline aggT query_extended() {
+    if (is_dirty()) {
+      return range_aggregate(window_position(0), (int)m_capacity);
+    }
+    aggT back = (m_istackSize == 0) ? m_op.identity : m_istackVal;
+    return m_op.combine(m_ostackVal[m_ostackSize - 1], m_op.combine(m_sealedVal, back));
+  }
+
+  // marks the tuple at the given offset as modified and returns its position
+  inline int modify(int offset) {
+    if (offset < 0 || offset >= (int)m_capacity) {
+      throw std::runtime_error("error: the offset exceeds the window");
+    }
+    sync_range_tree();
+    long seq = m_evicted + offset;
+    m_dirtyUntil = std::max(m_dirtyUntil, seq + 1);
+    return window_position(offset);
+  }
+};
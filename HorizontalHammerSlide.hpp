@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include "HammerSlide.hpp"
+
+/*
+ * HorizontalHammerSlide runs LANES independent windows of the same definition in lockstep,
+ * e.g. the small windows of eight keys. Their circular buffers, back stack aggregates and
+ * front stacks are interleaved lane by lane, so that every insert, evict, swap and query
+ * step handles all the windows with a single 256-bit operation instead of vectorizing
+ * inside one window. Only the int MIN and SUM kernels are supported.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) HorizontalHammerSlide {
+  static_assert(is_simd_supported<AggrFun, type>(), "only int MIN and SUM are supported");
+
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  static const int LANES = 8;
+
+  int m_windowSize;
+  int m_capacity;
+  int m_rear;
+  int m_istackSize;
+  int m_ostackSize;
+  __m256i m_istackVal;
+
+  // slot i of lane l is stored at i * LANES + l
+  std::vector<inT, tbb::cache_aligned_allocator<inT>> m_buffer;
+  std::vector<aggT, tbb::cache_aligned_allocator<aggT>> m_ostackVal;
+  AggrFun m_op;
+
+  // takes the slide like HammerSlide, although evictions of any size are supported
+  HorizontalHammerSlide(int windowSize, int windowSlide)
+      : m_windowSize(windowSize), m_buffer(windowSize * LANES), m_ostackVal(windowSize * LANES) {
+    if (windowSlide <= 0 || windowSlide > windowSize) {
+      throw std::runtime_error("error: invalid window definition");
+    }
+    reset();
+  }
+
+  // inserts vals[l] into the window of lane l
+  inline void insert(const inT* vals) {
+    if (m_capacity == m_windowSize) {
+      throw std::runtime_error("error: the window is full");
+    }
+    m_rear = (m_rear + 1 == m_windowSize) ? 0 : m_rear + 1;
+    __m256i val = _mm256_loadu_si256((const __m256i*)vals);
+    _mm256_store_si256((__m256i*)&m_buffer[m_rear * LANES], val);
+    m_istackVal = combine(m_istackVal, val);
+    m_istackSize++;
+    m_capacity++;
+  }
+
+  inline void evict(int numberOfItems = 1) {
+    while (numberOfItems > 0) {
+      if (m_ostackSize == 0) {
+        swap();
+      }
+      int n = std::min(numberOfItems, m_ostackSize);
+      if (n == 0) {
+        throw std::runtime_error("error: the window is empty");
+      }
+      m_ostackSize -= n;
+      m_capacity -= n;
+      numberOfItems -= n;
+    }
+  }
+
+  // writes the result of the window of lane l to results[l]
+  inline void query(outT* results) {
+    if (m_ostackSize == 0) {
+      swap();
+    }
+    __m256i front = _mm256_set1_epi32(m_op.identity);
+    if (m_ostackSize > 0) {
+      front = _mm256_load_si256((const __m256i*)&m_ostackVal[(m_ostackSize - 1) * LANES]);
+    }
+    _mm256_storeu_si256((__m256i*)results, combine(front, m_istackVal));
+  }
+
+  inline void reset() {
+    m_capacity = 0;
+    m_rear = -1;
+    m_istackSize = 0;
+    m_ostackSize = 0;
+    m_istackVal = _mm256_set1_epi32(m_op.identity);
+  }
+
+  /* helper functions */
+  inline __m256i combine(__m256i a, __m256i b) const {
+    return (type == MIN) ? _mm256_min_epi32(a, b) : _mm256_add_epi32(a, b);
+  }
+
+  inline void swap() {
+    __m256i tempValue = _mm256_set1_epi32(m_op.identity);
+    int inputIndex = m_rear;
+    for (int i = 0; i < m_istackSize; i++) {
+      tempValue = combine(_mm256_load_si256((const __m256i*)&m_buffer[inputIndex * LANES]),
+                          tempValue);
+      _mm256_store_si256((__m256i*)&m_ostackVal[i * LANES], tempValue);
+      inputIndex = (inputIndex == 0) ? m_windowSize - 1 : inputIndex - 1;
+    }
+    m_ostackSize = m_istackSize;
+    m_istackSize = 0;
+    m_istackVal = _mm256_set1_epi32(m_op.identity);
+  }
+};
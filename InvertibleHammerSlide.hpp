@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "CircularQueue.hpp"
+#include "HammerSlide.hpp"
+
+// detects aggregation functions that can remove a partial from another one
+template <typename AggrFun, typename = void>
+struct has_inverse_combine : std::false_type {};
+
+template <typename AggrFun>
+struct has_inverse_combine<
+    AggrFun, std::void_t<decltype(std::declval<const AggrFun&>().inverse_combine(
+                 std::declval<typename AggrFun::Partial>(),
+                 std::declval<typename AggrFun::Partial>()))>> : std::true_type {};
+
+/*
+ * InvertibleHammerSlide is a Subtract-on-Evict aggregator for invertible functions, such as
+ * Sum or Mean. It keeps a single running partial that is updated with combine on insertion
+ * and with inverse_combine on eviction, so there is neither a swap nor a front stack array.
+ * The evicted tuples are aggregated with SIMD instructions when possible. It offers the
+ * insert/evict/query API of HammerSlide.
+ *
+ * Note that with floating point partials, the running value may drift over time.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) InvertibleHammerSlide {
+  static_assert(has_inverse_combine<AggrFun>::value,
+                "the aggregation function must provide inverse_combine");
+
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  int m_windowSize;
+  int m_capacity;
+  aggT m_runningValue;
+
+  // a queue that holds the actual data
+  CircularQueue<inT> m_queue;
+  AggrFun m_op;
+
+  // takes the slide like HammerSlide, although evictions of any size are supported
+  InvertibleHammerSlide(int windowSize, int windowSlide = 1)
+      : m_windowSize(windowSize), m_capacity(0), m_runningValue(m_op.identity),
+        m_queue(windowSize) {
+    if (windowSlide <= 0 || windowSlide > windowSize) {
+      throw std::runtime_error("error: invalid window definition");
+    }
+  }
+
+  inline void insert(inT val) {
+    m_runningValue = m_op.combine(m_runningValue, m_op.lift(val));
+    m_queue.enqueue(val);
+    m_capacity++;
+  }
+
+  inline void insert(inT* vals, int start, int end) {
+    m_runningValue =
+        m_op.combine(m_runningValue, reduce_range<AggrFun, type>(m_op, vals, start, end));
+    m_queue.enqueue_many(vals, start, end);
+    m_capacity += end - start;
+  }
+
+  inline void evict(int numberOfItems = 1) {
+    // the evicted tuples may wrap around the end of the circular buffer
+    int queueSize = (int)m_queue.m_size;
+    int front = m_queue.m_front % queueSize;
+    int len = std::min(numberOfItems, queueSize - front);
+    aggT evicted = reduce_range<AggrFun, type>(m_op, m_queue.m_arr.data(), front, front + len);
+    if (len < numberOfItems) {
+      evicted = m_op.combine(evicted, reduce_range<AggrFun, type>(m_op, m_queue.m_arr.data(), 0,
+                                                                  numberOfItems - len));
+    }
+    m_runningValue = m_op.inverse_combine(m_runningValue, evicted);
+    m_capacity -= numberOfItems;
+    m_queue.dequeue_many(numberOfItems);
+  }
+
+  // isSIMD is only kept for compatibility with HammerSlide
+  inline outT query(bool isSIMD = true) {
+    (void)isSIMD;
+    return m_op.lower(m_runningValue);
+  }
+
+  inline void reset() {
+    m_capacity = 0;
+    m_runningValue = m_op.identity;
+    m_queue.reset();
+  }
+};
+
+// picks the Subtract-on-Evict aggregator when the aggregation function is invertible
+template <typename AggrFun, AggregationType type>
+using SlidingAggregator =
+    typename std::conditional<has_inverse_combine<AggrFun>::value,
+                              InvertibleHammerSlide<AggrFun, type>,
+                              HammerSlide<AggrFun, type>>::type;
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "HammerSlide.hpp"
+#include "utils/utils.h"
+
+/*
+ * KeyedHammerSlide evaluates a count-based window per key (group-by) for millions of keys.
+ * Instead of a HammerSlide object per key, an open-addressing hash table maps every key to
+ * a compact state, and all the keys share one slab of fixed-size rings of pane partials.
+ *
+ * Every ring holds windowSize / windowSlide panes and serves as both stacks of the
+ * Two-Stacks algorithm: the back panes keep their partials, and the swap overwrites the
+ * front panes in place with their suffix aggregates. Apart from the ring, a key costs one
+ * table entry of a few tens of bytes.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) KeyedHammerSlide {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  static constexpr long EMPTY_KEY = std::numeric_limits<long>::min();
+  // the number of tuples whose cache misses are overlapped by insert_grouped()
+  static constexpr int GROUP_SIZE = 8;
+
+  struct KeyState {
+    long m_key;
+    int m_ring;  // the index of the ring of the key in the slab
+    int m_head;  // the oldest pane of the ring
+    int m_frontSize;
+    int m_backSize;
+    int m_toPaneEnd;
+    aggT m_backVal;
+    aggT m_paneVal;
+  };
+
+  int m_windowSize;
+  int m_windowSlide;
+  int m_numOfPanes;
+  size_t m_numOfKeys;
+
+  std::vector<KeyState, NumaAllocator<KeyState>> m_table;
+  size_t m_mask;
+  std::vector<aggT, NumaAllocator<aggT>> m_slab;
+  // insert_grouped() only prefetches when the table and the slab exceed this many bytes
+  size_t m_cacheSize;
+  AggrFun m_op;
+
+  KeyedHammerSlide(int windowSize, int windowSlide, size_t expectedKeys = 1024)
+      : m_windowSize(windowSize), m_windowSlide(windowSlide), m_cacheSize(last_level_cache_size()) {
+    if (windowSlide <= 0 || windowSize % windowSlide != 0) {
+      throw std::runtime_error("error: the window size must be a multiple of the slide");
+    }
+    m_numOfPanes = windowSize / windowSlide;
+    size_t tableSize = 16;
+    while (tableSize < 2 * expectedKeys) tableSize *= 2;
+    m_table.resize(tableSize);
+    m_slab.reserve(expectedKeys * m_numOfPanes);
+    reset();
+  }
+
+  /*
+   * Inserts n (key, value) tuples and writes (key, result) for every window that closes,
+   * i.e., whenever a key completes a slide after its first windowSize tuples. The output
+   * buffers must have room for n results. Returns the number of results written.
+   * */
+  inline int insert(const long* keys, const inT* vals, int n, long* resultKeys, outT* results) {
+    return insert_range(keys, vals, 0, n, resultKeys, results, 0);
+  }
+
+  /*
+   * Same as insert(), but for key sets that exceed the last-level cache. The tuples are
+   * processed in groups through a pipeline of three stages: the table slots of a group are
+   * prefetched two groups ahead, the states of the next group are looked up and the ring
+   * slots that their tuples write are prefetched, and the current group is applied to the
+   * states looked up before. The cache misses of a group thus overlap with each other and
+   * with the work on the previous groups instead of stalling one after the other. Smaller key
+   * sets are inserted as by insert().
+   * */
+  inline int insert_grouped(const long* keys, const inT* vals, int n, long* resultKeys,
+                            outT* results) {
+    if (m_table.size() * sizeof(KeyState) + m_slab.capacity() * sizeof(aggT) <= m_cacheSize) {
+      return insert_range(keys, vals, 0, n, resultKeys, results, 0);
+    }
+    // the states of the current and of the next group, or nullptr for new keys
+    KeyState* states[2][GROUP_SIZE];
+    const KeyState* tables[2];
+    int numOfResults = 0;
+    prefetch_slots(keys, 0, std::min(n, 2 * GROUP_SIZE));
+    tables[0] = resolve_states(keys, 0, std::min(n, GROUP_SIZE), states[0]);
+    for (int start = 0, g = 0; start < n; start += GROUP_SIZE, g ^= 1) {
+      int end = std::min(n, start + GROUP_SIZE);
+      prefetch_slots(keys, std::min(n, end + GROUP_SIZE), std::min(n, end + 2 * GROUP_SIZE));
+      tables[g ^ 1] = resolve_states(keys, end, std::min(n, end + GROUP_SIZE), states[g ^ 1]);
+      // the states moved if the table has grown since they were looked up
+      bool isResolved = tables[g] == m_table.data();
+      for (int i = start; i < end; i++) {
+        KeyState* state = states[g][i - start];
+        if (state == nullptr || !isResolved) {
+          state = &find_or_insert(keys[i]);
+          isResolved &= tables[g] == m_table.data();
+        }
+        if (insert_tuple(*state, vals[i], results[numOfResults])) {
+          resultKeys[numOfResults++] = keys[i];
+        }
+      }
+    }
+    return numOfResults;
+  }
+
+  // the aggregate of the tuples of the current window of a key
+  inline outT query(long key) {
+    KeyState* state = find(key);
+    if (state == nullptr) {
+      throw std::runtime_error("error: unknown key");
+    }
+    aggT front = m_op.identity;
+    if (state->m_frontSize > 0) {
+      front = ring(*state)[state->m_head];
+    }
+    return m_op.lower(m_op.combine(m_op.combine(front, state->m_backVal), state->m_paneVal));
+  }
+
+  /*
+   * Moves the hash table and the slab to memory bound to a NUMA node, by default the one of
+   * the calling thread. When they grow, their new buffers stay on the node. Returns false if
+   * the kernel does not support it.
+   * */
+  inline bool bind_to_node(int node = current_numa_node()) {
+    bool bound = move_to_numa_node(m_table, node);
+    bound &= move_to_numa_node(m_slab, node);
+    return bound;
+  }
+
+  inline void reset() {
+    for (auto& state : m_table) {
+      state.m_key = EMPTY_KEY;
+    }
+    m_mask = m_table.size() - 1;
+    m_numOfKeys = 0;
+    m_slab.clear();
+  }
+
+  /* helper functions */
+  inline size_t hash(long key) const {
+    return (size_t)((uint64_t)key * 0x9E3779B97F4A7C15ULL >> 16) & m_mask;
+  }
+
+  // applies the tuples [start, end) and appends their results after the first numOfResults
+  inline int insert_range(const long* keys, const inT* vals, int start, int end,
+                          long* resultKeys, outT* results, int numOfResults) {
+    for (int i = start; i < end; i++) {
+      KeyState& state = find_or_insert(keys[i]);
+      if (insert_tuple(state, vals[i], results[numOfResults])) {
+        resultKeys[numOfResults++] = keys[i];
+      }
+    }
+    return numOfResults;
+  }
+
+  inline void prefetch_slots(const long* keys, int start, int end) {
+    for (int i = start; i < end; i++) {
+      // a state may straddle two cache lines
+      const char* first = (const char*)&m_table[hash(keys[i])];
+      const char* last = first + sizeof(KeyState) - 1;
+      PREFETCH(first);
+      PREFETCH(last);
+    }
+  }
+
+  /*
+   * Looks up the states of the keys, prefetches the ring slot of every state whose next tuple
+   * completes a pane, and returns the table that the states point into.
+   * */
+  inline const KeyState* resolve_states(const long* keys, int start, int end,
+                                        KeyState** states) {
+    for (int i = start; i < end; i++) {
+      KeyState* state = find(keys[i]);
+      states[i - start] = state;
+      if (state == nullptr || state->m_toPaneEnd > 1) continue;
+      int pos = state->m_head + state->m_frontSize + state->m_backSize;
+      const aggT* pane = ring(*state) + ((pos >= m_numOfPanes) ? pos - m_numOfPanes : pos);
+      PREFETCH(pane);
+    }
+    return m_table.data();
+  }
+
+  inline aggT* ring(const KeyState& state) {
+    return m_slab.data() + (size_t)state.m_ring * m_numOfPanes;
+  }
+
+  inline KeyState* find(long key) {
+    for (size_t pos = hash(key);; pos = (pos + 1) & m_mask) {
+      if (m_table[pos].m_key == key) return &m_table[pos];
+      if (m_table[pos].m_key == EMPTY_KEY) return nullptr;
+    }
+  }
+
+  inline KeyState& find_or_insert(long key) {
+    size_t pos = hash(key);
+    for (; m_table[pos].m_key != EMPTY_KEY; pos = (pos + 1) & m_mask) {
+      if (m_table[pos].m_key == key) return m_table[pos];
+    }
+    if (key == EMPTY_KEY) {
+      throw std::runtime_error("error: reserved key");
+    }
+    if (2 * (m_numOfKeys + 1) > m_table.size()) {
+      grow();
+      return find_or_insert(key);
+    }
+
+    // carve the ring of the new key from the slab
+    KeyState& state = m_table[pos];
+    state.m_key = key;
+    state.m_ring = (int)m_numOfKeys;
+    state.m_head = 0;
+    state.m_frontSize = 0;
+    state.m_backSize = 0;
+    state.m_toPaneEnd = m_windowSlide;
+    state.m_backVal = m_op.identity;
+    state.m_paneVal = m_op.identity;
+    m_slab.resize(m_slab.size() + m_numOfPanes);
+    m_numOfKeys++;
+    return state;
+  }
+
+  inline void grow() {
+    std::vector<KeyState, NumaAllocator<KeyState>> table(2 * m_table.size(),
+                                                         m_table.get_allocator());
+    std::swap(m_table, table);
+    m_mask = m_table.size() - 1;
+    for (auto& state : m_table) {
+      state.m_key = EMPTY_KEY;
+    }
+    // the rings stay in place, only the states move
+    for (auto& state : table) {
+      if (state.m_key == EMPTY_KEY) continue;
+      size_t pos = hash(state.m_key);
+      while (m_table[pos].m_key != EMPTY_KEY) pos = (pos + 1) & m_mask;
+      m_table[pos] = state;
+    }
+  }
+
+  // returns true when the tuple closes a window of the key
+  inline bool insert_tuple(KeyState& state, inT val, outT& result) {
+    state.m_paneVal = m_op.combine(state.m_paneVal, m_op.lift(val));
+    if (--state.m_toPaneEnd > 0) {
+      return false;
+    }
+
+    // the pane is complete and is pushed to the back stack
+    aggT* panes = ring(state);
+    int pos = state.m_head + state.m_frontSize + state.m_backSize;
+    panes[(pos >= m_numOfPanes) ? pos - m_numOfPanes : pos] = state.m_paneVal;
+    state.m_backVal = m_op.combine(state.m_backVal, state.m_paneVal);
+    state.m_backSize++;
+    state.m_paneVal = m_op.identity;
+    state.m_toPaneEnd = m_windowSlide;
+    if (state.m_frontSize + state.m_backSize < m_numOfPanes) {
+      return false;
+    }
+
+    if (state.m_frontSize == 0) {
+      swap(state, panes);
+    }
+    result = m_op.lower(m_op.combine(panes[state.m_head], state.m_backVal));
+
+    // evict the oldest pane
+    state.m_head = (state.m_head + 1 == m_numOfPanes) ? 0 : state.m_head + 1;
+    state.m_frontSize--;
+    return true;
+  }
+
+  // turns the back panes into suffix aggregates in place, from the newest to the oldest
+  inline void swap(KeyState& state, aggT* panes) {
+    aggT tempValue = m_op.identity;
+    int pos = state.m_head + state.m_backSize - 1;
+    if (pos >= m_numOfPanes) pos -= m_numOfPanes;
+    for (int i = 0; i < state.m_backSize; i++) {
+      tempValue = m_op.combine(panes[pos], tempValue);
+      panes[pos] = tempValue;
+      pos = (pos == 0) ? m_numOfPanes - 1 : pos - 1;
+    }
+    state.m_frontSize = state.m_backSize;
+    state.m_backSize = 0;
+    state.m_backVal = m_op.identity;
+  }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "HammerSlide.hpp"
+
+/*
+ * LandmarkWindow computes cumulative aggregates over all tuples since the last landmark
+ * (e.g., "since midnight") and emits one result every windowSlide tuples. Tuples are never
+ * evicted, so only the running partial of the completed panes and the partial of the
+ * current pane are kept. landmark() starts a new window from scratch.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) LandmarkWindow {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  int m_windowSlide;
+  int m_toPaneEnd;
+  // the aggregate of the completed panes since the landmark
+  aggT m_runningValue;
+  aggT m_paneValue;
+  AggrFun m_op;
+
+  LandmarkWindow(int windowSlide) : m_windowSlide(windowSlide) {
+    if (windowSlide <= 0) {
+      throw std::runtime_error("error: invalid window definition");
+    }
+    landmark();
+  }
+
+  // returns true if the tuple completes a slide and its result has been written to res
+  inline bool insert(inT val, outT& res) {
+    m_paneValue = m_op.combine(m_paneValue, m_op.lift(val));
+    if (--m_toPaneEnd == 0) {
+      res = emit();
+      return true;
+    }
+    return false;
+  }
+
+  /*
+   * Aggregates vals[start, end) and writes a result for every slide that completes within
+   * the batch to results. The output buffer must have room for (end - start) / slide + 1
+   * results. Returns the number of results written.
+   * */
+  inline int process(inT* vals, int start, int end, outT* results) {
+    int numOfResults = 0;
+    int pos = start;
+    while (pos < end) {
+      int len = std::min(end - pos, m_toPaneEnd);
+      m_paneValue =
+          m_op.combine(m_paneValue, reduce_range<AggrFun, type>(m_op, vals, pos, pos + len));
+      pos += len;
+      m_toPaneEnd -= len;
+      if (m_toPaneEnd == 0) {
+        results[numOfResults++] = emit();
+      }
+    }
+    return numOfResults;
+  }
+
+  // the aggregate of all the tuples since the landmark, including the current pane
+  inline outT query() { return m_op.lower(m_op.combine(m_runningValue, m_paneValue)); }
+
+  inline void landmark() {
+    m_runningValue = m_op.identity;
+    m_paneValue = m_op.identity;
+    m_toPaneEnd = m_windowSlide;
+  }
+
+  /* helper functions */
+  inline outT emit() {
+    m_runningValue = m_op.combine(m_runningValue, m_paneValue);
+    m_paneValue = m_op.identity;
+    m_toPaneEnd = m_windowSlide;
+    return m_op.lower(m_runningValue);
+  }
+};
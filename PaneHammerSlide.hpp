@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "HammerSlide.hpp"
+
+/*
+ * PaneHammerSlide stores a count-based window as panes of one slide instead of raw tuples.
+ * The tuples of the open pane are folded into a single partial on insertion and every
+ * finished pane becomes one entry of an inner HammerSlide over partials. The window thus
+ * keeps windowSize / windowSlide partials, e.g. 1K slots instead of 1M for a 1M/1K window.
+ *
+ * Since the raw tuples are gone, evictions must remove whole finished panes.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) PaneHammerSlide {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  int m_windowSize;
+  int m_windowSlide;
+  int m_capacity;
+
+  // the pane that is currently being aggregated
+  aggT m_paneVal;
+  int m_toPaneEnd;
+
+  HammerSlide<PartialAggregation<AggrFun>, type> m_panes;
+  AggrFun m_op;
+
+  PaneHammerSlide(int windowSize, int windowSlide)
+      : m_windowSize(windowSize),
+        m_windowSlide(windowSlide),
+        m_panes(std::max(windowSize / std::max(windowSlide, 1), 1), 1) {
+    if (windowSlide <= 0 || windowSize % windowSlide != 0) {
+      throw std::runtime_error("error: the window size must be a multiple of the slide");
+    }
+    reset();
+  }
+
+  inline void insert(inT val) {
+    m_paneVal = m_op.combine(m_paneVal, m_op.lift(val));
+    m_capacity++;
+    if (--m_toPaneEnd == 0) {
+      pane_finished();
+    }
+  }
+
+  inline void insert(inT* vals, int start, int end) {
+    while (start < end) {
+      int len = std::min(end - start, m_toPaneEnd);
+      m_paneVal =
+          m_op.combine(m_paneVal, reduce_range<AggrFun, type>(m_op, vals, start, start + len));
+      m_capacity += len;
+      start += len;
+      m_toPaneEnd -= len;
+      if (m_toPaneEnd == 0) {
+        pane_finished();
+      }
+    }
+  }
+
+  inline void evict(int numberOfItems = 1) {
+    if (numberOfItems < 0 || numberOfItems % m_windowSlide != 0 ||
+        numberOfItems / m_windowSlide > (int)m_panes.m_capacity) {
+      throw std::runtime_error("error: only whole panes can be evicted");
+    }
+    int numOfPanes = numberOfItems / m_windowSlide;
+    while (numOfPanes > 0) {
+      if (m_panes.m_ostackSize == 0) {
+        m_panes.swap();
+      }
+      int n = std::min(numOfPanes, m_panes.m_ostackSize);
+      m_panes.evict(n);
+      numOfPanes -= n;
+    }
+    m_capacity -= numberOfItems;
+  }
+
+  inline outT query() {
+    aggT value = (m_panes.m_capacity == 0) ? m_op.identity : m_panes.query_partial();
+    return m_op.lower(m_op.combine(value, m_paneVal));
+  }
+
+  inline void reset() {
+    m_capacity = 0;
+    m_paneVal = m_op.identity;
+    m_toPaneEnd = m_windowSlide;
+    m_panes.reset();
+  }
+
+  /* helper functions */
+  inline void pane_finished() {
+    m_panes.insert(m_paneVal);
+    m_paneVal = m_op.identity;
+    m_toPaneEnd = m_windowSlide;
+  }
+};
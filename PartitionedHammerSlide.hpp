@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <tbb/concurrent_queue.h>
+
+#include "KeyedHammerSlide.hpp"
+#include "utils/utils.h"
+
+/*
+ * PartitionedHammerSlide scales keyed windows over several cores. Every worker thread owns
+ * a KeyedHammerSlide for a disjoint partition of the keys, so the workers share no window
+ * state. The thread that calls insert() acts as the router: it appends every tuple to the
+ * open batch of the worker that owns its key and hands full batches over through a
+ * per-worker queue. Empty batches return to the router through a second queue, so that
+ * the steady state does not allocate.
+ *
+ * The tuples of a key always reach the same worker in order, so every key sees the same
+ * results as with a single KeyedHammerSlide. Each worker appends its results to its own
+ * buffers, which can be read after flush().
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) PartitionedHammerSlide {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Out outT;
+
+  static const int BATCH_SIZE = 4096;
+  static const int BATCHES_PER_WORKER = 8;
+
+  struct Batch {
+    int m_size;
+    std::vector<long> m_keys;
+    std::vector<inT, tbb::cache_aligned_allocator<inT>> m_vals;
+
+    Batch() : m_size(0), m_keys(BATCH_SIZE), m_vals(BATCH_SIZE) {}
+  };
+
+  struct alignas(64) Worker {
+    KeyedHammerSlide<AggrFun, type> m_window;
+    tbb::concurrent_bounded_queue<Batch*> m_queue;
+    tbb::concurrent_bounded_queue<Batch*> m_free;
+    std::vector<std::unique_ptr<Batch>> m_batches;
+    Batch* m_open;
+
+    // the results of the worker, which are only read after a flush
+    std::vector<long> m_resultKeys;
+    std::vector<outT> m_results;
+    std::thread m_thread;
+
+    Worker(int windowSize, int windowSlide) : m_window(windowSize, windowSlide) {
+      for (int i = 0; i < BATCHES_PER_WORKER; i++) {
+        m_batches.emplace_back(new Batch());
+        m_free.push(m_batches.back().get());
+      }
+      m_free.pop(m_open);
+    }
+  };
+
+  int m_numOfWorkers;
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::atomic<long> m_pending;
+
+  /*
+   * Starts numOfWorkers threads. With pinning, worker i runs on core i + 1, while the router
+   * keeps core 0, and the window state of a worker moves to the NUMA node of its core.
+   * */
+  PartitionedHammerSlide(int windowSize, int windowSlide, int numOfWorkers = WORKER_THREADS,
+                         bool pin = true)
+      : m_numOfWorkers(numOfWorkers), m_pending(0) {
+    if (numOfWorkers <= 0) {
+      throw std::runtime_error("error: at least one worker is required");
+    }
+    for (int w = 0; w < m_numOfWorkers; w++) {
+      m_workers.emplace_back(new Worker(windowSize, windowSlide));
+    }
+    for (int w = 0; w < m_numOfWorkers; w++) {
+      m_workers[w]->m_thread = std::thread([this, w, pin] {
+        if (pin) {
+          set_cpu_manually(w + 1);
+          m_workers[w]->m_window.bind_to_node();
+        }
+        run(*m_workers[w]);
+      });
+    }
+  }
+
+  ~PartitionedHammerSlide() {
+    for (auto& worker : m_workers) {
+      worker->m_queue.push(nullptr);
+    }
+    for (auto& worker : m_workers) {
+      worker->m_thread.join();
+    }
+  }
+
+  inline void insert(const long* keys, const inT* vals, int n) {
+    for (int i = 0; i < n; i++) {
+      Worker& worker = *m_workers[partition(keys[i])];
+      Batch* batch = worker.m_open;
+      batch->m_keys[batch->m_size] = keys[i];
+      batch->m_vals[batch->m_size] = vals[i];
+      if (++batch->m_size == BATCH_SIZE) {
+        dispatch(worker);
+      }
+    }
+  }
+
+  // hands over all the open batches and waits until the workers have processed them
+  inline void flush() {
+    for (auto& worker : m_workers) {
+      if (worker->m_open->m_size > 0) {
+        dispatch(*worker);
+      }
+    }
+    while (m_pending.load(std::memory_order_acquire) > 0) {
+      PAUSE;
+    }
+  }
+
+  // drops the results that have been read, after a flush
+  inline void clear_results() {
+    for (auto& worker : m_workers) {
+      worker->m_resultKeys.clear();
+      worker->m_results.clear();
+    }
+  }
+
+  /* helper functions */
+  inline int partition(long key) const {
+    // use other bits of the hash than the hash tables of the workers
+    return (int)(((uint64_t)key * 0x9E3779B97F4A7C15ULL >> 48) % m_numOfWorkers);
+  }
+
+  inline void dispatch(Worker& worker) {
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    worker.m_queue.push(worker.m_open);
+    worker.m_free.pop(worker.m_open);
+  }
+
+  inline void run(Worker& worker) {
+    std::vector<long> resultKeys(BATCH_SIZE);
+    std::vector<outT> results(BATCH_SIZE);
+    while (true) {
+      Batch* batch;
+      worker.m_queue.pop(batch);
+      if (batch == nullptr) {
+        return;
+      }
+      int numOfResults = worker.m_window.insert(batch->m_keys.data(), batch->m_vals.data(),
+                                                batch->m_size, resultKeys.data(), results.data());
+      worker.m_resultKeys.insert(worker.m_resultKeys.end(), resultKeys.begin(),
+                                 resultKeys.begin() + numOfResults);
+      worker.m_results.insert(worker.m_results.end(), results.begin(),
+                              results.begin() + numOfResults);
+      batch->m_size = 0;
+      worker.m_free.push(batch);
+      m_pending.fetch_sub(1, std::memory_order_release);
+    }
+  }
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "HammerSlide.hpp"
+
+/*
+ * ReversedHammerSlide stores the tuples in the circular buffer at decreasing positions, so
+ * the newest tuple is at the lowest address. The swap visits the back stack from the newest
+ * to the oldest tuple and therefore streams forward through memory, which suits the hardware
+ * prefetcher. With SIMD, every slide of the back stack is aggregated with aligned vector
+ * loads where possible and the front stack gets one entry per slide, as in HammerSlide.
+ * Otherwise the scalar swap fills every entry of the front stack.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) ReversedHammerSlide {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  int m_windowSize;
+  int m_windowSlide;
+  int m_capacity;
+
+  // the position of the newest tuple, which is also the top of the back stack
+  int m_rear;
+  int m_istackSize;
+  int m_ostackSize;
+  aggT m_istackVal;
+
+  std::vector<inT, tbb::cache_aligned_allocator<inT>> m_buffer;
+  std::vector<aggT, tbb::cache_aligned_allocator<aggT>> m_ostackVal;
+  AggrFun m_op;
+
+  ReversedHammerSlide(int windowSize, int windowSlide)
+      : m_windowSize(windowSize),
+        m_windowSlide(windowSlide),
+        m_buffer(windowSize),
+        m_ostackVal(windowSize) {
+    reset();
+  }
+
+  inline void insert(inT val) {
+    if (m_capacity == m_windowSize) {
+      throw std::runtime_error("error: the window is full");
+    }
+    m_rear = (m_rear == 0) ? m_windowSize - 1 : m_rear - 1;
+    m_buffer[m_rear] = val;
+    m_istackVal = m_op.combine(m_op.lift(val), m_istackVal);
+    m_istackSize++;
+    m_capacity++;
+  }
+
+  inline void insert(const inT* vals, int start, int end) {
+    if (m_capacity + (end - start) > m_windowSize) {
+      throw std::runtime_error("error: the window is full");
+    }
+    m_istackVal = m_op.combine(reduce_range<AggrFun, type>(m_op, vals, start, end), m_istackVal);
+    m_istackSize += end - start;
+    m_capacity += end - start;
+    // copy the tuples in reverse order below the newest one, wrapping at most once
+    while (start < end) {
+      int top = (m_rear == 0) ? m_windowSize : m_rear;
+      int len = std::min(end - start, top);
+      std::reverse_copy(vals + start, vals + start + len, m_buffer.data() + top - len);
+      m_rear = top - len;
+      start += len;
+    }
+  }
+
+  inline void evict(int numberOfItems = 1) {
+    m_ostackSize -= numberOfItems;
+    m_capacity -= numberOfItems;
+  }
+
+  inline outT query(bool isSIMD = true) {
+    if (m_ostackSize == 0) {
+      swap(isSIMD);
+    }
+    aggT front = (m_ostackSize == 0) ? m_op.identity : m_ostackVal[m_ostackSize - 1];
+    return m_op.lower(m_op.combine(front, m_istackVal));
+  }
+
+  inline void reset() {
+    m_capacity = 0;
+    m_rear = 0;
+    m_istackSize = 0;
+    m_ostackSize = 0;
+    m_istackVal = m_op.identity;
+  }
+
+  /* helper functions */
+  inline void swap(bool isSIMD = true) {
+    int pos = m_rear;
+    aggT tempValue = m_op.identity;
+    // the tuples of a slide are aggregated from the newest to the oldest one, which is only
+    // correct for the commutative functions with SIMD kernels
+    if (!is_simd_supported<AggrFun, type>() || m_windowSlide < 16 || !isSIMD ||
+        m_istackSize % m_windowSlide != 0) {
+      for (int i = 0; i < m_istackSize; i++) {
+        tempValue = m_op.combine(m_op.lift(m_buffer[pos]), tempValue);
+        m_ostackVal[i] = tempValue;
+        if (++pos == m_windowSize) pos = 0;
+      }
+    } else {
+      for (int i = 0; i < m_istackSize; i += m_windowSlide) {
+        // a slide is contiguous in memory unless it wraps around the end of the buffer
+        int len = std::min(m_windowSlide, m_windowSize - pos);
+        aggT slideValue = reduce_range<AggrFun, type>(m_op, m_buffer.data(), pos, pos + len);
+        if (len < m_windowSlide) {
+          slideValue = m_op.combine(
+              slideValue,
+              reduce_range<AggrFun, type>(m_op, m_buffer.data(), 0, m_windowSlide - len));
+        }
+        tempValue = m_op.combine(slideValue, tempValue);
+        m_ostackVal[i + m_windowSlide - 1] = tempValue;
+        pos += m_windowSlide;
+        if (pos >= m_windowSize) pos -= m_windowSize;
+      }
+    }
+    m_ostackSize = m_istackSize;
+    m_istackSize = 0;
+    m_istackVal = m_op.identity;
+  }
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <tbb/cache_aligned_allocator.h>
+
+#include "utils/utils.h"
+
+/*
+ * SPSCQueue hands batches of tuples from one producer thread (e.g. a parser) to one consumer
+ * thread (e.g. a HammerSlide) without locks or allocation. It owns a fixed number of
+ * cache-aligned batch slots: the producer fills the slot returned by acquire() in place and
+ * publishes it, and the consumer passes the slot returned by front() directly to the bulk
+ * insert of a window before releasing it, so the tuples are never copied.
+ *
+ * The indices of the two sides live on separate cache lines, and each side caches the last
+ * index it read from the other one, so that the shared lines only move when a side runs out
+ * of slots. On x86, stores are not reordered with other stores and loads are not reordered
+ * with other loads, so compiler barriers suffice to order the slot contents and the indices.
+ * A side that has to wait spins for a while and then yields its core, in case the other side
+ * shares it.
+ * */
+template <typename T>
+struct alignas(64) SPSCQueue {
+  static const int SPIN_LIMIT = 1024;
+
+  int m_numOfBatches;
+  int m_batchSize;
+  int m_stride;  // the distance between two slots, rounded up to whole cache lines
+  long m_mask;
+  std::vector<T, tbb::cache_aligned_allocator<T>> m_slots;
+  std::vector<int> m_sizes;
+
+  // written by the consumer
+  alignas(64) VOLATILE long m_head;
+  long m_cachedTail;
+
+  // written by the producer
+  alignas(64) VOLATILE long m_tail;
+  long m_cachedHead;
+  VOLATILE bool m_closed;
+
+  SPSCQueue(int numOfBatches, int batchSize)
+      : m_numOfBatches(1), m_batchSize(batchSize), m_head(0), m_cachedTail(0), m_tail(0),
+        m_cachedHead(0), m_closed(false) {
+    if (numOfBatches <= 0 || batchSize <= 0) {
+      throw std::runtime_error("error: the queue needs at least one non-empty batch");
+    }
+    while (m_numOfBatches < numOfBatches) m_numOfBatches *= 2;
+    m_mask = m_numOfBatches - 1;
+    int perLine = 64 / sizeof(T);
+    m_stride = (batchSize + perLine - 1) / perLine * perLine;
+    m_slots.resize((size_t)m_numOfBatches * m_stride);
+    m_sizes.resize(m_numOfBatches);
+  }
+
+  /* producer */
+  // waits for a free slot and returns it, to be filled with up to batchSize tuples
+  inline T* acquire() {
+    for (int spins = 0; m_tail - m_cachedHead == m_numOfBatches; spins++) {
+      m_cachedHead = m_head;
+      if (m_tail - m_cachedHead == m_numOfBatches) wait(spins);
+    }
+    return slot(m_tail);
+  }
+
+  // makes the first size tuples of the acquired slot visible to the consumer
+  inline void publish(int size) {
+    if (size > m_batchSize) {
+      throw std::runtime_error("error: the batch is too large");
+    }
+    m_sizes[m_tail & m_mask] = size;
+    COMPILER_NO_REORDER(m_tail = m_tail + 1);
+  }
+
+  // tells the consumer that no more batches will be published
+  inline void close() { COMPILER_NO_REORDER(m_closed = true); }
+
+  /* consumer */
+  // waits for the oldest published batch and returns it, or nullptr once the queue is closed
+  // and drained
+  inline T* front(int& size) {
+    for (int spins = 0; m_head == m_cachedTail; spins++) {
+      bool closed = m_closed;
+      COMPILER_BARRIER;
+      m_cachedTail = m_tail;
+      if (m_head == m_cachedTail) {
+        if (closed) return nullptr;
+        wait(spins);
+      }
+    }
+    COMPILER_BARRIER;
+    size = m_sizes[m_head & m_mask];
+    return slot(m_head);
+  }
+
+  // returns the slot of the batch returned by front() to the producer
+  inline void release() { COMPILER_NO_REORDER(m_head = m_head + 1); }
+
+  /* helper functions */
+  inline void wait(int spins) {
+    if (spins < SPIN_LIMIT) {
+      PAUSE;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  inline T* slot(long index) { return m_slots.data() + (size_t)(index & m_mask) * m_stride; }
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include "HammerSlide.hpp"
+
+/*
+ * StaticHammerSlide is a HammerSlide variant for windows whose size and slide are known at
+ * compile time. The circular buffer and the front stack are fixed-capacity arrays inside the
+ * object, all the index arithmetic uses constants, and the pane loops of the swap have a
+ * constant trip count, so the compiler can unroll them.
+ *
+ * The front stack keeps one entry per pane (slide), so tuples are evicted in whole slides.
+ * Since the size is a multiple of the slide, a pane never wraps around the end of the buffer
+ * and, when the slide is a multiple of 8, every pane starts at a 32-byte boundary.
+ * */
+template <typename AggrFun, AggregationType type, int Size, int Slide>
+struct alignas(64) StaticHammerSlide {
+  static_assert(Slide > 0 && Size % Slide == 0, "the size must be a multiple of the slide");
+
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  static constexpr int NUM_OF_PANES = Size / Slide;
+
+  alignas(64) std::array<inT, Size> m_buffer;
+  std::array<aggT, NUM_OF_PANES> m_ostackVal;
+
+  // the position of the oldest tuple and of the next tuple in the buffer
+  int m_front;
+  int m_rear;
+  int m_capacity;
+  int m_istackSize;
+  int m_ostackSize;
+  aggT m_istackVal;
+  AggrFun m_op;
+
+  StaticHammerSlide() { reset(); }
+
+  inline void insert(inT val) {
+    if (m_capacity == Size) {
+      throw std::runtime_error("error: the window is full");
+    }
+    m_buffer[m_rear] = val;
+    m_rear = (m_rear + 1) % Size;
+    m_istackVal = m_op.combine(m_istackVal, m_op.lift(val));
+    m_istackSize++;
+    m_capacity++;
+  }
+
+  inline void insert(const inT* vals, int start, int end) {
+    int numOfVals = end - start;
+    if (m_capacity + numOfVals > Size) {
+      throw std::runtime_error("error: the window is full");
+    }
+    int len = std::min(numOfVals, Size - m_rear);
+    std::memcpy(&m_buffer[m_rear], vals + start, sizeof(inT) * len);
+    std::memcpy(&m_buffer[0], vals + start + len, sizeof(inT) * (numOfVals - len));
+    m_rear = (m_rear + numOfVals) % Size;
+    m_istackVal = m_op.combine(m_istackVal, reduce_range<AggrFun, type>(m_op, vals, start, end));
+    m_istackSize += numOfVals;
+    m_capacity += numOfVals;
+  }
+
+  inline void evict(int numberOfItems = Slide) {
+    if (numberOfItems % Slide != 0) {
+      throw std::runtime_error("error: only whole slides can be evicted");
+    }
+    while (numberOfItems > 0) {
+      if (m_ostackSize == 0) {
+        swap();
+      }
+      int n = std::min(numberOfItems, m_ostackSize);
+      if (n == 0) {
+        throw std::runtime_error("error: the window is empty");
+      }
+      m_front = (m_front + n) % Size;
+      m_ostackSize -= n;
+      m_capacity -= n;
+      numberOfItems -= n;
+    }
+  }
+
+  inline outT query() {
+    if (m_ostackSize == 0) {
+      swap();
+    }
+    aggT front = (m_ostackSize == 0) ? m_op.identity : m_ostackVal[m_ostackSize / Slide - 1];
+    return m_op.lower(m_op.combine(front, m_istackVal));
+  }
+
+  inline void reset() {
+    m_front = 0;
+    m_rear = 0;
+    m_capacity = 0;
+    m_istackSize = 0;
+    m_ostackSize = 0;
+    m_istackVal = m_op.identity;
+  }
+
+  /* helper functions */
+  // moves the whole panes of the back stack to the front stack, newest to oldest
+  inline void swap() {
+    int numOfPanes = m_istackSize / Slide;
+    int remaining = m_istackSize % Slide;
+    aggT tempValue = m_op.identity;
+    int pane = (m_front / Slide + numOfPanes - 1) % NUM_OF_PANES;
+    for (int i = 0; i < numOfPanes; i++) {
+      tempValue = m_op.combine(reduce_pane(pane * Slide), tempValue);
+      m_ostackVal[i] = tempValue;
+      pane = (pane == 0) ? NUM_OF_PANES - 1 : pane - 1;
+    }
+    m_ostackSize = numOfPanes * Slide;
+
+    // the tuples of an incomplete pane stay in the back stack
+    int paneStart = (m_front + m_ostackSize) % Size;
+    m_istackVal = m_op.identity;
+    for (int i = 0; i < remaining; i++) {
+      m_istackVal = m_op.combine(m_istackVal, m_op.lift(m_buffer[paneStart + i]));
+    }
+    m_istackSize = remaining;
+  }
+
+  inline aggT reduce_pane(int start) const {
+    if constexpr (is_simd_supported<AggrFun, type>() && Slide % 8 == 0) {
+      const __m256i* f4 = (const __m256i*)(m_buffer.data() + start);
+      __m256i tempVal = _mm256_set1_epi32(m_op.identity);
+      for (int i = 0; i < Slide / 8; i++) {
+        tempVal = (type == MIN) ? _mm256_min_epi32(tempVal, _mm256_load_si256(f4 + i))
+                                : _mm256_add_epi32(tempVal, _mm256_load_si256(f4 + i));
+      }
+      const U256i r = {tempVal};
+      aggT value = m_op.identity;
+      for (int i = 0; i < 8; i++) {
+        value = m_op.combine(value, r.a[i]);
+      }
+      return value;
+    } else {
+      aggT value = m_op.identity;
+      for (int i = 0; i < Slide; i++) {
+        value = m_op.combine(value, m_op.lift(m_buffer[start + i]));
+      }
+      return value;
+    }
+  }
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <tbb/concurrent_queue.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include "KeyedHammerSlide.hpp"
+#include "utils/utils.h"
+
+/*
+ * StealingHammerSlide balances keyed windows with skewed keys over the threads of a TBB task
+ * arena. Unlike PartitionedHammerSlide, the keys are spread over many more shards than
+ * threads, and a shard is not bound to a thread: the router appends every tuple to the open
+ * batch of its shard and queues full batches in the inbox of the shard, which is scheduled
+ * as a task whenever it has work. TBB's work stealing moves these tasks to idle threads, so
+ * that the shards that share a thread with a heavy-hitter key are not held back.
+ *
+ * A shard is run by at most one thread at a time and drains its inbox in order, so the tuples
+ * of a key are applied in order, as with a single KeyedHammerSlide. Each shard appends its
+ * results to its own buffers, which can be read after flush().
+ *
+ * A shard owns at most BATCHES_PER_SHARD batches. When a shard falls behind the router, e.g.
+ * because of a heavy-hitter key, and has no free batch left, the router drains the inbox of
+ * that shard itself, or yields while another thread does, so memory stays bounded. It never
+ * waits for the tasks of other shards.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) StealingHammerSlide {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Out outT;
+
+  static const int BATCH_SIZE = 1024;
+  static const int SHARDS_PER_THREAD = 16;
+  static const int BATCHES_PER_SHARD = 4;
+
+  struct Batch {
+    int m_size;
+    std::vector<long> m_keys;
+    std::vector<inT, tbb::cache_aligned_allocator<inT>> m_vals;
+
+    Batch() : m_size(0), m_keys(BATCH_SIZE), m_vals(BATCH_SIZE) {}
+  };
+
+  struct alignas(64) Shard {
+    KeyedHammerSlide<AggrFun, type> m_window;
+    tbb::concurrent_queue<Batch*> m_inbox;
+    tbb::concurrent_queue<Batch*> m_free;
+    std::vector<std::unique_ptr<Batch>> m_batches;  // only touched by the router
+    Batch* m_open;
+    std::atomic<bool> m_scheduled;
+    // whether a thread applies the inbox, either the task of the shard or the router
+    std::atomic<bool> m_running;
+
+    // the results of the shard, which are only read after a flush
+    std::vector<long> m_resultKeys;
+    std::vector<outT> m_results;
+
+    Shard(int windowSize, int windowSlide)
+        : m_window(windowSize, windowSlide), m_scheduled(false), m_running(false) {
+      m_batches.emplace_back(new Batch());
+      m_open = m_batches.back().get();
+    }
+  };
+
+  int m_numOfShards;
+  std::vector<std::unique_ptr<Shard>> m_shards;
+  tbb::task_arena m_arena;
+  tbb::task_group m_group;
+  std::unique_ptr<PinningObserver> m_observer;
+
+  /*
+   * Runs the shards on up to numOfThreads threads, including the thread that calls flush().
+   * With pinning, the worker threads of the arena are placed next to the calling thread.
+   * */
+  StealingHammerSlide(int windowSize, int windowSlide, int numOfThreads = WORKER_THREADS,
+                      bool pin = true)
+      : m_numOfShards(numOfThreads * SHARDS_PER_THREAD), m_arena(numOfThreads) {
+    if (numOfThreads <= 0) {
+      throw std::runtime_error("error: at least one thread is required");
+    }
+    for (int s = 0; s < m_numOfShards; s++) {
+      m_shards.emplace_back(new Shard(windowSize, windowSlide));
+    }
+    if (pin) {
+      m_observer.reset(new PinningObserver(m_arena));
+    }
+  }
+
+  ~StealingHammerSlide() {
+    m_arena.execute([&] { m_group.wait(); });
+  }
+
+  inline void insert(const long* keys, const inT* vals, int n) {
+    m_arena.execute([&] {
+      for (int i = 0; i < n; i++) {
+        Shard& shard = *m_shards[partition(keys[i])];
+        Batch* batch = shard.m_open;
+        batch->m_keys[batch->m_size] = keys[i];
+        batch->m_vals[batch->m_size] = vals[i];
+        if (++batch->m_size == BATCH_SIZE) {
+          dispatch(shard);
+        }
+      }
+    });
+  }
+
+  // hands over all the open batches and helps the arena until they have been processed
+  inline void flush() {
+    m_arena.execute([&] {
+      for (auto& shard : m_shards) {
+        if (shard->m_open->m_size > 0) {
+          dispatch(*shard);
+        }
+      }
+      m_group.wait();
+    });
+  }
+
+  // drops the results that have been read, after a flush
+  inline void clear_results() {
+    for (auto& shard : m_shards) {
+      shard->m_resultKeys.clear();
+      shard->m_results.clear();
+    }
+  }
+
+  /* helper functions */
+  inline int partition(long key) const {
+    // use other bits of the hash than the hash tables of the shards
+    return (int)(((uint64_t)key * 0x9E3779B97F4A7C15ULL >> 48) % m_numOfShards);
+  }
+
+  // called within the arena
+  inline void dispatch(Shard& shard) {
+    shard.m_inbox.push(shard.m_open);
+    if (!shard.m_scheduled.exchange(true)) {
+      m_group.run([this, &shard] { run(shard); });
+    }
+    if (shard.m_free.try_pop(shard.m_open)) {
+      return;
+    }
+    if ((int)shard.m_batches.size() < BATCHES_PER_SHARD) {
+      shard.m_batches.emplace_back(new Batch());
+      shard.m_open = shard.m_batches.back().get();
+      return;
+    }
+    // the router drains the inbox of the shard inline, even if its task is still queued, as
+    // there may be no other thread to run it, and only waits while a worker drains it
+    while (!shard.m_free.try_pop(shard.m_open)) {
+      if (!drain(shard)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  inline void run(Shard& shard) {
+    while (true) {
+      // the router may hold the shard, in which case it drains the inbox itself
+      if (!drain(shard)) {
+        std::this_thread::yield();
+      }
+
+      // a batch queued after the inbox ran empty either sees the flag cleared and schedules
+      // a new task, or is picked up here
+      shard.m_scheduled.store(false);
+      if (shard.m_inbox.empty() || shard.m_scheduled.exchange(true)) {
+        return;
+      }
+    }
+  }
+
+  // applies the queued batches of the shard, unless another thread does, and returns whether
+  // it did
+  inline bool drain(Shard& shard) {
+    if (shard.m_running.exchange(true)) {
+      return false;
+    }
+    std::vector<long> resultKeys(BATCH_SIZE);
+    std::vector<outT> results(BATCH_SIZE);
+    Batch* batch;
+    while (shard.m_inbox.try_pop(batch)) {
+      int numOfResults =
+          shard.m_window.insert(batch->m_keys.data(), batch->m_vals.data(), batch->m_size,
+                                resultKeys.data(), results.data());
+      shard.m_resultKeys.insert(shard.m_resultKeys.end(), resultKeys.begin(),
+                                resultKeys.begin() + numOfResults);
+      shard.m_results.insert(shard.m_results.end(), results.begin(),
+                             results.begin() + numOfResults);
+      batch->m_size = 0;
+      shard.m_free.push(batch);
+    }
+    shard.m_running.store(false);
+    return true;
+  }
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "HammerSlide.hpp"
+
+/*
+ * TimeWindowDriver evaluates event-time windows [k * slide, k * slide + size) on top of
+ * HammerSlide. Tuples must arrive in timestamp order and are only inserted into HammerSlide
+ * while they belong to the earliest open window; later tuples are staged. Results are not
+ * produced by query() calls: a watermark w promises that no tuple with a timestamp below w
+ * will follow, so watermark() evicts and emits every window that ends at or before w in
+ * one pass. Windows without tuples are skipped.
+ *
+ * The buffer holds at most capacity tuples. Since the number of tuples per window varies,
+ * HammerSlide always uses the scalar swap.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) TimeWindowDriver {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  long m_windowSize;
+  long m_windowSlide;
+  long m_paneSize;
+  int m_numOfPanes;
+
+  // the earliest window that has not been emitted yet
+  bool m_isStarted;
+  long m_windowStart;
+  long m_windowEnd;
+  long m_lastTimestamp;
+  long m_watermark;
+
+  // number of buffered tuples per pane of the current window
+  std::vector<int> m_paneCounts;
+
+  // tuples that belong to windows after the current one
+  std::vector<long> m_pendingTimestamps;
+  std::vector<inT, tbb::cache_aligned_allocator<inT>> m_pendingVals;
+  size_t m_pendingHead;
+
+  HammerSlide<AggrFun, type> m_hammerslide;
+
+  TimeWindowDriver(long windowSize, long windowSlide, int capacity)
+      : m_windowSize(windowSize),
+        m_windowSlide(windowSlide),
+        m_paneSize(std::gcd(windowSize, windowSlide)),
+        m_hammerslide(capacity, 1) {
+    if (windowSize <= 0 || windowSlide <= 0 || windowSlide > windowSize) {
+      throw std::runtime_error("error: invalid window definition");
+    }
+    m_numOfPanes = (int)(m_windowSize / m_paneSize);
+    m_paneCounts.resize(m_numOfPanes);
+    reset();
+  }
+
+  inline void insert(long timestamp, inT val) { insert(&timestamp, &val, 0, 1); }
+
+  // bulk insertion of tuples with non-negative timestamps in non-decreasing order
+  inline void insert(const long* timestamps, inT* vals, int start, int end) {
+    if (start == end) {
+      return;
+    }
+    if (timestamps[start] < m_lastTimestamp || timestamps[start] < m_watermark) {
+      throw std::runtime_error("error: out-of-order tuple");
+    }
+    // a rejected batch leaves no trace, and a watermark never fails halfway
+    check_capacity(timestamps, start, end);
+    if (!m_isStarted) {
+      start_window(timestamps[start]);
+    }
+
+    int pos = start;
+    if (m_pendingHead == m_pendingTimestamps.size()) {
+      pos = insert_window_tuples(timestamps, vals, start, end);
+    }
+    m_pendingTimestamps.insert(m_pendingTimestamps.end(), timestamps + pos, timestamps + end);
+    m_pendingVals.insert(m_pendingVals.end(), vals + pos, vals + end);
+    m_lastTimestamp = timestamps[end - 1];
+  }
+
+  /*
+   * Emits (window end, result) for every window that ends at or before the watermark and
+   * returns the number of results appended.
+   * */
+  inline int watermark(long watermark, std::vector<std::pair<long, outT>>& results) {
+    m_watermark = std::max(m_watermark, watermark);
+    int numOfResults = 0;
+    while (m_isStarted && m_windowEnd <= watermark) {
+      // all the tuples of the window are in HammerSlide at this point
+      if (m_hammerslide.m_capacity > 0) {
+        results.emplace_back(m_windowEnd, m_hammerslide.query(false));
+        numOfResults++;
+      }
+      advance_window();
+    }
+    return numOfResults;
+  }
+
+  inline void reset() {
+    m_hammerslide.reset();
+    m_isStarted = false;
+    m_windowStart = 0;
+    m_windowEnd = 0;
+    m_lastTimestamp = 0;
+    m_watermark = 0;
+    std::fill(m_paneCounts.begin(), m_paneCounts.end(), 0);
+    m_pendingTimestamps.clear();
+    m_pendingVals.clear();
+    m_pendingHead = 0;
+  }
+
+  /* helper functions */
+  // the first window that contains the timestamp
+  inline long first_window_start(long timestamp) {
+    long diff = timestamp - m_windowSize;
+    long k = (diff >= 0) ? diff / m_windowSlide
+                         : -((-diff + m_windowSlide - 1) / m_windowSlide);
+    return (k + 1) * m_windowSlide;
+  }
+
+  inline void start_window(long timestamp) {
+    m_windowStart = std::max(first_window_start(timestamp), 0L);
+    m_windowEnd = m_windowStart + m_windowSize;
+    m_isStarted = true;
+  }
+
+  /*
+   * Throws if a window would hold more tuples than the capacity once the tuples are added, as
+   * the circular buffer would silently overwrite the oldest tuples of the window. Of the
+   * windows that end with a tuple, the earliest one that contains it holds the most tuples,
+   * so it suffices to count the tuples from its start, which only moves forward.
+   * */
+  inline void check_capacity(const long* timestamps, int start, int end) {
+    long capacity = m_hammerslide.m_windowSize;
+    long numOfBuffered = (long)m_hammerslide.m_capacity;
+    // the buffered tuples before the window start, which are in the panes of the current
+    // window, in the pending tuples and in the batch
+    long numOfEarlier = 0;
+    long pane = m_windowStart / m_paneSize;
+    auto pending = std::lower_bound(m_pendingTimestamps.begin() + m_pendingHead,
+                                    m_pendingTimestamps.end(),
+                                    std::max(first_window_start(timestamps[start]), 0L));
+    int batch = start;
+    for (int i = start; i < end; i++) {
+      long windowStart = std::max(first_window_start(timestamps[i]), 0L);
+      for (; m_isStarted && pane < m_windowEnd / m_paneSize && pane * m_paneSize < windowStart;
+           pane++) {
+        numOfEarlier += m_paneCounts[pane % m_numOfPanes];
+      }
+      while (pending != m_pendingTimestamps.end() && *pending < windowStart) pending++;
+      while (timestamps[batch] < windowStart) batch++;
+      long numOfTuples = numOfBuffered - numOfEarlier + (m_pendingTimestamps.end() - pending) +
+                         (i + 1 - batch);
+      if (numOfTuples > capacity) {
+        throw std::runtime_error("error: the window holds more tuples than the capacity");
+      }
+    }
+  }
+
+  // inserts the prefix of the tuples that belongs to the current window and returns where
+  // it ends
+  inline int insert_window_tuples(const long* timestamps, inT* vals, int start, int end) {
+    int pos = start;
+    while (pos < end && timestamps[pos] < m_windowEnd) {
+      m_paneCounts[(timestamps[pos] / m_paneSize) % m_numOfPanes]++;
+      pos++;
+    }
+    if (pos > start) {
+      m_hammerslide.insert_simple_range(vals, start, pos);
+    }
+    return pos;
+  }
+
+  inline void advance_window() {
+    // evict the panes that are not part of the next window
+    long nextStart = m_windowStart + m_windowSlide;
+    int numOfItems = 0;
+    for (long pane = m_windowStart / m_paneSize; pane < nextStart / m_paneSize; pane++) {
+      numOfItems += m_paneCounts[pane % m_numOfPanes];
+      m_paneCounts[pane % m_numOfPanes] = 0;
+    }
+    evict(numOfItems);
+
+    bool hasPending = m_pendingHead < m_pendingTimestamps.size();
+    if (m_hammerslide.m_capacity == 0) {
+      if (!hasPending) {
+        m_isStarted = false;
+        return;
+      }
+      // skip the empty windows up to the first one that contains a pending tuple
+      nextStart = std::max(nextStart, first_window_start(m_pendingTimestamps[m_pendingHead]));
+    }
+    m_windowStart = nextStart;
+    m_windowEnd = m_windowStart + m_windowSize;
+
+    if (hasPending) {
+      m_pendingHead = insert_window_tuples(m_pendingTimestamps.data(), m_pendingVals.data(),
+                                           (int)m_pendingHead, (int)m_pendingTimestamps.size());
+      // drop the consumed tuples once they make up half of the staging area
+      if (m_pendingHead >= m_pendingTimestamps.size() / 2) {
+        m_pendingTimestamps.erase(m_pendingTimestamps.begin(),
+                                  m_pendingTimestamps.begin() + m_pendingHead);
+        m_pendingVals.erase(m_pendingVals.begin(), m_pendingVals.begin() + m_pendingHead);
+        m_pendingHead = 0;
+      }
+    }
+  }
+
+  inline void evict(int numberOfItems) {
+    while (numberOfItems > 0) {
+      if (m_hammerslide.m_ostackSize == 0) {
+        m_hammerslide.swap(false);
+      }
+      int n = std::min(numberOfItems, m_hammerslide.m_ostackSize);
+      m_hammerslide.evict(n);
+      numberOfItems -= n;
+    }
+  }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "HammerSlide.hpp"
+
+/*
+ * TumblingWindow handles count-based windows with windowSlide == windowSize. Such windows
+ * never overlap, so no tuples need to be buffered and no swap is required: the input is
+ * aggregated directly into a running partial that is emitted and reset at every window
+ * boundary. It uses O(1) memory regardless of the window size.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) TumblingWindow {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  int m_windowSize;
+  int m_toWindowEnd;
+  aggT m_runningValue;
+  AggrFun m_op;
+
+  TumblingWindow(int windowSize) : m_windowSize(windowSize) {
+    if (windowSize <= 0) {
+      throw std::runtime_error("error: invalid window definition");
+    }
+    reset();
+  }
+
+  // returns true if the tuple closes a window and its result has been written to res
+  inline bool insert(inT val, outT& res) {
+    m_runningValue = m_op.combine(m_runningValue, m_op.lift(val));
+    if (--m_toWindowEnd == 0) {
+      res = emit();
+      return true;
+    }
+    return false;
+  }
+
+  /*
+   * Aggregates vals[start, end) and writes the result of every window that closes within
+   * the batch to results. The output buffer must have room for (end - start) / size + 1
+   * results. Returns the number of results written.
+   * */
+  inline int process(inT* vals, int start, int end, outT* results) {
+    int numOfResults = 0;
+    int pos = start;
+    while (pos < end) {
+      int len = std::min(end - pos, m_toWindowEnd);
+      m_runningValue = m_op.combine(m_runningValue,
+                                    reduce_range<AggrFun, type>(m_op, vals, pos, pos + len));
+      pos += len;
+      m_toWindowEnd -= len;
+      if (m_toWindowEnd == 0) {
+        results[numOfResults++] = emit();
+      }
+    }
+    return numOfResults;
+  }
+
+  // the aggregate of the tuples of the window that is still open
+  inline outT query() { return m_op.lower(m_runningValue); }
+
+  inline void reset() {
+    m_runningValue = m_op.identity;
+    m_toWindowEnd = m_windowSize;
+  }
+
+  /* helper functions */
+  inline outT emit() {
+    outT res = m_op.lower(m_runningValue);
+    reset();
+    return res;
+  }
+};
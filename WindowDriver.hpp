@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "HammerSlide.hpp"
+
+enum SlicingTechnique { PANES, PAIRS };
+
+/*
+ * WindowDriver owns the insert/evict/query coordination that HammerSlide expects from
+ * its caller for count-based windows. It consumes raw input batches, splits them at
+ * slice boundaries, feeds every slice to HammerSlide with bulk insertion and writes one
+ * result per completed window to an output buffer.
+ *
+ * With PANES the stream is cut every gcd(size, slide) tuples, while PAIRS cuts it only at
+ * window starts and ends (at most two fragments per slide), resulting in fewer and longer
+ * bulk insertions. Both techniques produce identical results.
+ * */
+template <typename AggrFun, AggregationType type>
+struct alignas(64) WindowDriver {
+  typedef typename AggrFun::In inT;
+  typedef typename AggrFun::Partial aggT;
+  typedef typename AggrFun::Out outT;
+
+  int m_windowSize;
+  int m_windowSlide;
+  int m_paneSize;
+  SlicingTechnique m_slicing;
+  bool m_isSIMD;
+
+  // the lengths of the slices that repeat in every window slide
+  std::vector<int> m_slices;
+  int m_currentSlice;
+  int m_toSliceEnd;
+  int m_toWindowEnd;
+
+  HammerSlide<AggrFun, type> m_hammerslide;
+
+  WindowDriver(int windowSize, int windowSlide, SlicingTechnique slicing = PANES)
+      : m_windowSize(windowSize),
+        m_windowSlide(windowSlide),
+        m_paneSize(std::gcd(windowSize, windowSlide)),
+        m_slicing(slicing),
+        m_hammerslide(windowSize, m_paneSize) {
+    if (windowSize <= 0 || windowSlide <= 0 || windowSlide > windowSize) {
+      throw std::runtime_error("error: invalid window definition");
+    }
+    // the SIMD swap expects the back stack to start at the beginning of the circular
+    // buffer, which only holds when the slide divides the size
+    m_isSIMD = (type == MIN || type == SUM) && (m_windowSize % m_windowSlide == 0) &&
+               (m_paneSize % 8 == 0);
+
+    if (m_slicing == PANES) {
+      m_slices.assign(m_windowSlide / m_paneSize, m_paneSize);
+    } else {
+      int fragment = m_windowSize % m_windowSlide;
+      if (fragment == 0) {
+        m_slices.push_back(m_windowSlide);
+      } else {
+        m_slices.push_back(fragment);
+        m_slices.push_back(m_windowSlide - fragment);
+      }
+    }
+    reset();
+  }
+
+  /*
+   * Inserts vals[start, end) and writes the result of every window that closes within the
+   * batch to results. The output buffer must have room for (end - start) / slide + 1
+   * results. Returns the number of results written.
+   * */
+  inline int process(inT* vals, int start, int end, outT* results) {
+    int numOfResults = 0;
+    int pos = start;
+    while (pos < end) {
+      int len = std::min(end - pos, std::min(m_toSliceEnd, m_toWindowEnd));
+      insert_slice(vals, pos, pos + len);
+      pos += len;
+      m_toSliceEnd -= len;
+      m_toWindowEnd -= len;
+
+      if (m_toSliceEnd == 0) {
+        m_currentSlice = (m_currentSlice + 1) % (int)m_slices.size();
+        m_toSliceEnd = m_slices[m_currentSlice];
+      }
+
+      if (m_toWindowEnd == 0) {
+        results[numOfResults++] = m_hammerslide.query(m_isSIMD);
+        evict(m_windowSlide);
+        m_toWindowEnd = m_windowSlide;
+      }
+    }
+    return numOfResults;
+  }
+
+  inline void reset() {
+    m_hammerslide.reset();
+    m_currentSlice = 0;
+    m_toSliceEnd = m_slices[0];
+    m_toWindowEnd = m_windowSize;
+  }
+
+  /* helper functions */
+  inline void insert_slice(inT* vals, int start, int end) {
+    // bulk insertion reads 256-bit vectors from an aligned base pointer
+    bool isAligned = (reinterpret_cast<uintptr_t>(vals) % 32 == 0) && (start % 8 == 0) &&
+                     (end % 8 == 0);
+    if (m_isSIMD && isAligned) {
+      m_hammerslide.insert(vals, start, end);
+    } else {
+      m_hammerslide.insert_simple_range(vals, start, end);
+    }
+  }
+
+  // HammerSlide can only evict from its front stack, so swap in between when a slide
+  // spans the boundary between the two stacks
+  inline void evict(int numberOfItems) {
+    while (numberOfItems > 0) {
+      if (m_hammerslide.m_ostackSize == 0) {
+        m_hammerslide.swap(m_isSIMD);
+      }
+      int n = std::min(numberOfItems, m_hammerslide.m_ostackSize);
+      m_hammerslide.evict(n);
+      numberOfItems -= n;
+    }
+  }
+};
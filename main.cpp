@@ -1,17 +1,349 @@
 #include <sys/mman.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <thread>
 
 #include "HammerSlide.hpp"
+#include "PartitionedHammerSlide.hpp"
+#include "ReversedHammerSlide.hpp"
+#include "SPSCQueue.hpp"
+#include "StaticHammerSlide.hpp"
+#include "StealingHammerSlide.hpp"
 #include "utils/AggregationFunctions.hpp"
 #include "utils/SystemConf.h"
 #include "utils/utils.h"
 
 static volatile size_t result = 0;
 
+// the window definition of the static variant is fixed at compile time
+static const int STATIC_WINDOW_SIZE = 1024;
+static const int STATIC_WINDOW_SLIDE = 64;
+
+// the skew of the keys of the skewed benchmark, where key k has a frequency of 1 / k^s
+static const double ZIPF_EXPONENT = 1.0;
+
+// generates the keys and values of the keyed benchmarks, with uniform or Zipf-distributed keys
+static void keyed_input(std::vector<long>& keys,
+                        std::vector<int, tbb::cache_aligned_allocator<int>>& input, bool skewed,
+                        size_t numOfKeys = NUM_OF_KEYS) {
+  keys.resize(INPUT_SIZE);
+  input.resize(INPUT_SIZE);
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<long> keyDist(0, numOfKeys - 1);
+  std::uniform_int_distribution<int> dist(1, INPUT_SIZE * 2);
+  std::vector<double> cdf(skewed ? numOfKeys : 0);
+  double sum = 0;
+  for (int k = 0; k < (int)cdf.size(); k++) {
+    sum += 1.0 / std::pow(k + 1, ZIPF_EXPONENT);
+    cdf[k] = sum;
+  }
+  std::uniform_real_distribution<double> zipfDist(0, sum);
+  for (unsigned int i = 0; i < INPUT_SIZE; i++) {
+    keys[i] = skewed ? std::lower_bound(cdf.begin(), cdf.end(), zipfDist(mt)) - cdf.begin()
+                     : keyDist(mt);
+    input[i] = dist(mt);
+  }
+}
+
+// feeds the input to a keyed engine for the duration of the benchmark
+template <typename Engine>
+static double keyed_throughput(Engine& engine, const std::vector<long>& keys,
+                               const std::vector<int, tbb::cache_aligned_allocator<int>>& input) {
+  size_t tuples = 0;
+  auto t1 = std::chrono::high_resolution_clock::now();
+  auto t2 = t1;
+  auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+  while (true) {
+    engine.insert(keys.data(), input.data(), (int)input.size());
+    engine.flush();
+    engine.clear_results();
+
+    tuples += input.size();
+    t2 = std::chrono::high_resolution_clock::now();
+    time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+    if (time_span.count() >= (double)DURATION / 1000) {
+      break;
+    }
+  }
+  return tuples / time_span.count();
+}
+
+// compares the keyed insertion with and without group prefetching, for the configured number
+// of keys and for enough keys that their window states exceed the last-level cache
+static void keyed_benchmark() {
+  set_cpu_manually(0);
+
+  typedef KeyedHammerSlide<Sum<int, int, int>, SUM> Window;
+  size_t stateSize = 2 * sizeof(Window::KeyState) + (WINDOW_SIZE / WINDOW_SLIDE) * sizeof(int);
+  size_t cacheSize = last_level_cache_size();
+  if (cacheSize == 0) cacheSize = 32 * 1024 * 1024;
+  std::vector<size_t> sizes = {NUM_OF_KEYS};
+  if (NUM_OF_KEYS * stateSize <= cacheSize) {
+    sizes.push_back(2 * cacheSize / stateSize);
+  }
+
+  for (size_t numOfKeys : sizes) {
+    std::vector<long> keys;
+    std::vector<int, tbb::cache_aligned_allocator<int>> input;
+    keyed_input(keys, input, false, numOfKeys);
+    std::vector<long> resultKeys(input.size());
+    std::vector<int> results(input.size());
+
+    Window window(WINDOW_SIZE, WINDOW_SLIDE, numOfKeys);
+    // create the state of every key before the measurements
+    for (size_t k = 0; k < numOfKeys; k++) {
+      window.find_or_insert(k);
+    }
+    std::cout << numOfKeys << " keys with " << numOfKeys * stateSize / (1024 * 1024)
+              << " MiB of window state (last-level cache: " << cacheSize / (1024 * 1024)
+              << " MiB)" << std::endl;
+    // alternate between both variants, so that drifts of the machine affect both alike
+    size_t tuples = 0;
+    double elapsed[2] = {0, 0};
+    while (std::min(elapsed[0], elapsed[1]) < (double)DURATION / 1000) {
+      for (int grouped = 0; grouped <= 1; grouped++) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        int numOfResults =
+            grouped ? window.insert_grouped(keys.data(), input.data(), (int)input.size(),
+                                            resultKeys.data(), results.data())
+                    : window.insert(keys.data(), input.data(), (int)input.size(),
+                                    resultKeys.data(), results.data());
+        auto t2 = std::chrono::high_resolution_clock::now();
+        elapsed[grouped] += std::chrono::duration<double>(t2 - t1).count();
+        result += numOfResults;
+      }
+      tuples += input.size();
+    }
+    for (int grouped = 0; grouped <= 1; grouped++) {
+      std::cout << "Throughput of " << numOfKeys << " keys "
+                << (grouped ? "with" : "without") << " group prefetching: "
+                << tuples / elapsed[grouped] << " tuples/sec (speedup "
+                << elapsed[0] / elapsed[grouped] << ")" << std::endl;
+    }
+  }
+}
+
+// measures how the keyed windows scale with the number of worker threads
+static void partitioned_benchmark() {
+  set_cpu_manually(0);
+
+  std::vector<long> keys;
+  std::vector<int, tbb::cache_aligned_allocator<int>> input;
+  keyed_input(keys, input, false);
+
+  double baseline = 0;
+  for (unsigned int workers = 1; workers <= WORKER_THREADS; workers *= 2) {
+    PartitionedHammerSlide<Sum<int, int, int>, SUM> engine(WINDOW_SIZE, WINDOW_SLIDE, workers);
+    double throughput = keyed_throughput(engine, keys, input);
+    if (workers == 1) baseline = throughput;
+    std::cout << "Throughput with " << workers << " workers: " << throughput
+              << " tuples/sec (speedup " << throughput / baseline << ")" << std::endl;
+  }
+}
+
+// compares static key partitioning with work stealing on Zipf-distributed keys
+static void skewed_benchmark() {
+  std::vector<long> keys;
+  std::vector<int, tbb::cache_aligned_allocator<int>> input;
+  keyed_input(keys, input, true);
+
+  {
+    PartitionedHammerSlide<Sum<int, int, int>, SUM> engine(WINDOW_SIZE, WINDOW_SLIDE,
+                                                           WORKER_THREADS);
+    std::cout << "Throughput of skewed keys with " << WORKER_THREADS
+              << " partitioned workers: " << keyed_throughput(engine, keys, input)
+              << " tuples/sec" << std::endl;
+  }
+  {
+    StealingHammerSlide<Sum<int, int, int>, SUM> engine(WINDOW_SIZE, WINDOW_SLIDE,
+                                                        WORKER_THREADS);
+    std::cout << "Throughput of skewed keys with " << WORKER_THREADS
+              << " work-stealing threads: " << keyed_throughput(engine, keys, input)
+              << " tuples/sec" << std::endl;
+  }
+}
+
+// the number of slides that the ingest thread can run ahead of the pipelined window
+static const int PIPELINE_DEPTH = 64;
+
+// measures a window fed through an SPSCQueue by an ingest thread on another core
+static void pipeline_benchmark() {
+  std::vector<int, tbb::cache_aligned_allocator<int>> input(INPUT_SIZE);
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(1, INPUT_SIZE * 2);
+  for (auto& i : input) {
+    i = dist(mt);
+  }
+
+  // the ingest thread copies every slide into a slot, as a parser would
+  SPSCQueue<int> queue(PIPELINE_DEPTH, WINDOW_SLIDE);
+  std::atomic<bool> stop(false);
+  // both stages share the L3 cache of a socket, on separate physical cores when possible
+  std::thread ingest([&] {
+    set_cpu_manually(0, COMPACT);
+    while (!stop.load(std::memory_order_relaxed)) {
+      for (unsigned int idx = 0; idx < input.size(); idx += WINDOW_SLIDE) {
+        auto next_idx = std::min(idx + WINDOW_SLIDE, (unsigned int)input.size());
+        int* slot = queue.acquire();
+        std::copy(input.begin() + idx, input.begin() + next_idx, slot);
+        queue.publish(next_idx - idx);
+      }
+    }
+    queue.close();
+  });
+
+  set_cpu_manually(1, COMPACT);
+  HammerSlide<Sum<int, int, int>, SUM> hammerslide(WINDOW_SIZE, WINDOW_SLIDE);
+  size_t tuples = 0;
+  auto t1 = std::chrono::high_resolution_clock::now();
+  auto t2 = t1;
+  auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+  int size;
+  for (int* batch; (batch = queue.front(size)) != nullptr; queue.release()) {
+    if (hammerslide.m_capacity + size > WINDOW_SIZE) {
+      result += hammerslide.query();
+      hammerslide.evict(hammerslide.m_capacity + size - WINDOW_SIZE);
+    }
+    hammerslide.insert(batch, 0, size);
+
+    tuples += size;
+    if (tuples % input.size() == 0) {
+      t2 = std::chrono::high_resolution_clock::now();
+      time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+      if (time_span.count() >= (double)DURATION / 1000) {
+        stop.store(true, std::memory_order_relaxed);
+      }
+    }
+  }
+  ingest.join();
+  std::cout << "Throughput with a pipelined ingest thread: " << tuples / time_span.count()
+            << " tuples/sec (" << result << ")" << std::endl;
+}
+
+// measures the stall of a (SIMD) query that swaps a full window, sequentially and in parallel
+static void swap_benchmark() {
+  std::vector<int, tbb::cache_aligned_allocator<int>> input(WINDOW_SIZE);
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(1, INPUT_SIZE * 2);
+  for (auto& i : input) {
+    i = dist(mt);
+  }
+
+  HammerSlide<Sum<int, int, int>, SUM> hammerslide(WINDOW_SIZE, WINDOW_SLIDE);
+  double sequential = 0;
+  for (int parallel = 0; parallel <= 1; parallel++) {
+    hammerslide.set_parallel_swap(parallel ? 1 : 0, WORKER_THREADS);
+    size_t swaps = 0;
+    double stall = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto t2 = t1;
+    while (std::chrono::duration<double>(t2 - t1).count() < (double)DURATION / 1000) {
+      hammerslide.reset();
+      hammerslide.insert(input.data(), 0, WINDOW_SIZE);
+      auto t3 = std::chrono::high_resolution_clock::now();
+      result += hammerslide.query();
+      t2 = std::chrono::high_resolution_clock::now();
+      stall += std::chrono::duration<double, std::milli>(t2 - t3).count();
+      swaps++;
+    }
+    stall /= swaps;
+    if (!parallel) sequential = stall;
+    std::cout << "Swap stall " << (parallel ? "in parallel" : "sequentially") << " with "
+              << WORKER_THREADS << " workers: " << stall << " ms (speedup "
+              << sequential / stall << ")" << std::endl;
+  }
+}
+
+// measures the SIMD operations with the window on the local and on a remote NUMA node
+static void numa_benchmark() {
+  set_cpu_manually(0);
+  int local = current_numa_node();
+  int remote = -1;
+  for (int node : numa_nodes()) {
+    if (node != local) {
+      remote = node;
+      break;
+    }
+  }
+
+  std::vector<int, tbb::cache_aligned_allocator<int>> input(INPUT_SIZE);
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(1, INPUT_SIZE * 2);
+  for (auto& i : input) {
+    i = dist(mt);
+  }
+
+  for (int node : {local, remote}) {
+    const char* placement = (node == local) ? "local" : "remote";
+    if (node < 0) {
+      std::cout << "Throughput with the window on a remote node: skipped (single NUMA node)"
+                << std::endl;
+      continue;
+    }
+    HammerSlide<Sum<int, int, int>, SUM> hammerslide(WINDOW_SIZE, WINDOW_SLIDE);
+    if (!hammerslide.bind_to_node(node)) {
+      std::cout << "warning: the window could not be bound to node " << node << std::endl;
+    }
+
+    unsigned int idx = std::min(WINDOW_SIZE, (unsigned int)input.size());
+    hammerslide.insert(input.data(), 0, idx);
+    size_t tuples = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto t2 = t1;
+    auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+    while (true) {
+      for (; idx < input.size();) {
+        result += hammerslide.query();
+        hammerslide.evict(WINDOW_SLIDE);
+        auto next_idx = std::min(idx + WINDOW_SLIDE, (unsigned int)input.size());
+        hammerslide.insert(input.data(), idx, next_idx);
+        idx = next_idx;
+      }
+
+      idx = 0;  // start from the beginning
+      tuples += input.size();
+      t2 = std::chrono::high_resolution_clock::now();
+      time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+      if (time_span.count() >= (double)DURATION / 1000) {
+        break;
+      }
+    }
+    std::cout << "Throughput with the window on the " << placement << " node " << node << ": "
+              << tuples / time_span.count() << " tuples/sec (" << result << ")" << std::endl;
+  }
+}
+
 int main(int argc, const char** argv) {
   parseCLArgs(argc, argv);
+  if (BENCHMARK == KEYED) {
+    keyed_benchmark();
+    return 0;
+  }
+  if (BENCHMARK == PARTITIONED) {
+    partitioned_benchmark();
+    return 0;
+  }
+  if (BENCHMARK == PIPELINE) {
+    pipeline_benchmark();
+    return 0;
+  }
+  if (BENCHMARK == SKEWED) {
+    skewed_benchmark();
+    return 0;
+  }
+  if (BENCHMARK == NUMA) {
+    numa_benchmark();
+    return 0;
+  }
+  if (BENCHMARK == SWAP) {
+    swap_benchmark();
+    return 0;
+  }
 
   // bind the process to one core
   const int core_id = 1;
@@ -103,5 +435,107 @@ int main(int argc, const char** argv) {
   }
   std::cout << "Throughput with SIMD: " << tuples / time_span.count()
             << " tuples/sec (" << result << ")" << std::endl;
+
+  // reset hammerslide
+  hammerslide.reset();
+
+  // measure batch processing
+  std::vector<int> results(input.size() / WINDOW_SLIDE + 1);
+  result = 0;
+  tuples = 0;
+  t1 = std::chrono::high_resolution_clock::now();
+  t2 = t1;
+  time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+  while (true) {
+    size_t numOfResults = hammerslide.process(input.data(), input.size(), results.data());
+    for (size_t i = 0; i < numOfResults; i++) {
+      result += results[i];
+    }
+
+    tuples += input.size();
+    t2 = std::chrono::high_resolution_clock::now();
+    time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+    if (time_span.count() >= (double)DURATION / 1000) {
+      break;
+    }
+  }
+  std::cout << "Throughput with batch processing: " << tuples / time_span.count()
+            << " tuples/sec (" << result << ")" << std::endl;
+
+  // measure the reversed layout, where the swap streams forward through memory
+  ReversedHammerSlide<Sum<int, int, int>, SUM> reversedHammerslide(WINDOW_SIZE, WINDOW_SLIDE);
+  first = true;
+  result = 0;
+  idx = 0;
+  tuples = 0;
+  t1 = std::chrono::high_resolution_clock::now();
+  t2 = t1;
+  time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+  while (true) {
+    if (first) {
+      idx = std::min(WINDOW_SIZE, (unsigned int)input.size());
+      reversedHammerslide.insert(input.data(), 0, idx);
+      first = false;
+    }
+
+    for (; idx < input.size();) {
+      result += reversedHammerslide.query();
+      reversedHammerslide.evict(WINDOW_SLIDE);
+      auto next_idx = std::min(idx + WINDOW_SLIDE, (unsigned int)input.size());
+      reversedHammerslide.insert(input.data(), idx, next_idx);
+      idx = next_idx;
+    }
+
+    idx = 0;  // start from the beginning
+    tuples += input.size();
+    t2 = std::chrono::high_resolution_clock::now();
+    time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+    if (time_span.count() >= (double)DURATION / 1000) {
+      break;
+    }
+  }
+  std::cout << "Throughput with reversed layout: " << tuples / time_span.count()
+            << " tuples/sec (" << result << ")" << std::endl;
+
+  // measure the static variant with the same SIMD operations
+  if (WINDOW_SIZE != STATIC_WINDOW_SIZE || WINDOW_SLIDE != STATIC_WINDOW_SLIDE) {
+    std::cout << "Throughput with static window: skipped (compiled for " << STATIC_WINDOW_SIZE
+              << "/" << STATIC_WINDOW_SLIDE << ")" << std::endl;
+    return 0;
+  }
+  auto staticHammerslide = std::make_unique<
+      StaticHammerSlide<Sum<int, int, int>, SUM, STATIC_WINDOW_SIZE, STATIC_WINDOW_SLIDE>>();
+  first = true;
+  result = 0;
+  idx = 0;
+  tuples = 0;
+  t1 = std::chrono::high_resolution_clock::now();
+  t2 = t1;
+  time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+  while (true) {
+    if (first) {
+      idx = std::min(WINDOW_SIZE, (unsigned int)input.size());
+      staticHammerslide->insert(input.data(), 0, idx);
+      first = false;
+    }
+
+    for (; idx < input.size();) {
+      result += staticHammerslide->query();
+      staticHammerslide->evict(WINDOW_SLIDE);
+      auto next_idx = std::min(idx + WINDOW_SLIDE, (unsigned int)input.size());
+      staticHammerslide->insert(input.data(), idx, next_idx);
+      idx = next_idx;
+    }
+
+    idx = 0;  // start from the beginning
+    tuples += input.size();
+    t2 = std::chrono::high_resolution_clock::now();
+    time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+    if (time_span.count() >= (double)DURATION / 1000) {
+      break;
+    }
+  }
+  std::cout << "Throughput with static window: " << tuples / time_span.count()
+            << " tuples/sec (" << result << ")" << std::endl;
   return 0;
 }
@@ -0,0 +1,40 @@
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "CascadingHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_cascade(const std::vector<std::pair<int, int>>& windows, int batchSize) {
+  auto input = random_input(32 * 1024);
+
+  CascadingHammerSlide<AggrFun, type> cascade(windows);
+  std::vector<std::vector<typename AggrFun::Out>> res;
+  for (int start = 0; start < (int)input.size(); start += batchSize) {
+    int end = std::min(start + batchSize, (int)input.size());
+    cascade.process(input.data(), start, end, res);
+  }
+
+  REQUIRE(res.size() == windows.size());
+  for (size_t level = 0; level < windows.size(); level++) {
+    auto& window = windows[level];
+    CHECK(res[level] == naive_windows<AggrFun>(input, window.first, window.second));
+  }
+}
+
+TEST_CASE("CascadingHammerSlide testing", "[cascading]") {
+  SECTION("SUM operations") {
+    check_cascade<Sum<int, int, int>, SUM>({{64, 16}, {1024, 64}, {8192, 1024}}, 1000);
+    check_cascade<Sum<int, int, int>, SUM>({{10, 5}, {60, 20}, {600, 60}}, 33);
+  }
+
+  SECTION("MIN operations") {
+    check_cascade<Min<int, int, int>, MIN>({{64, 16}, {1024, 64}, {8192, 1024}}, 4096);
+    check_cascade<Min<int, int, int>, MIN>({{8, 8}, {64, 8}, {512, 64}}, 7);
+  }
+
+  SECTION("invalid levels") {
+    CHECK_THROWS(CascadingHammerSlide<Sum<int, int, int>, SUM>({{64, 16}, {100, 20}}));
+  }
+}
@@ -0,0 +1,67 @@
+#include <atomic>
+#include <thread>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "ConcurrentHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+TEST_CASE("ConcurrentHammerSlide testing", "[concurrent]") {
+  SECTION("single thread") {
+    auto input = random_input(16 * 1024);
+    ConcurrentHammerSlide<Min<int, int, int>, MIN> hammerslide(256, 32);
+    std::vector<int> res;
+    hammerslide.insert(input.data(), 0, 256);
+    for (int idx = 256;; idx += 32) {
+      int result = hammerslide.query();
+      CHECK(hammerslide.concurrent_query() == result);
+      res.push_back(result);
+      if (idx + 32 > (int)input.size()) break;
+      hammerslide.evict(32);
+      // the readers also see the window while the front stack is empty
+      CHECK(hammerslide.concurrent_query() ==
+            naive_windows<Min<int, int, int>>(
+                InputVector(input.begin() + idx - 224, input.begin() + idx), 224, 1)[0]);
+      for (int i = idx; i < idx + 32; i++) hammerslide.insert(input[i]);
+    }
+    CHECK(res == naive_windows<Min<int, int, int>>(input, 256, 32));
+    CHECK(hammerslide.m_version % 2 == 0);
+  }
+
+  SECTION("readers during ingestion") {
+    // with a stream of ones, every consistent state has a sum between the window size minus
+    // the slide and the window size
+    const int windowSize = 4096;
+    const int windowSlide = 256;
+    ConcurrentHammerSlide<Sum<int, int, int>, SUM> hammerslide(windowSize, windowSlide);
+    std::vector<int, tbb::cache_aligned_allocator<int>> ones(windowSize, 1);
+    hammerslide.insert(ones.data(), 0, windowSize);
+
+    std::atomic<bool> done(false);
+    std::atomic<long> reads(0), violations(0);
+    std::thread reader([&] {
+      while (!done.load(std::memory_order_relaxed)) {
+        int result = hammerslide.concurrent_query();
+        if (result < windowSize - windowSlide || result > windowSize) violations++;
+        reads++;
+      }
+    });
+
+    for (int i = 0; i < 2000; i++) {
+      CHECK(hammerslide.query() == windowSize);
+      hammerslide.evict(windowSlide);
+      if (i % 2 == 0) {
+        hammerslide.insert(ones.data(), 0, windowSlide);
+      } else {
+        for (int j = 0; j < windowSlide; j++) hammerslide.insert(1);
+      }
+      if (i % 100 == 0) std::this_thread::yield();
+    }
+    done = true;
+    reader.join();
+    CHECK(reads > 0);
+    CHECK(violations == 0);
+  }
+}
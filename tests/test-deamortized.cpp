@@ -0,0 +1,75 @@
+#include <deque>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "DeamortizedHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_random_operations(int windowSize, bool isBulk) {
+  auto input = random_input(64 * 1024);
+  std::mt19937 mt(11);
+  std::uniform_int_distribution<int> dist(0, 2 * windowSize);
+
+  AggrFun op;
+  DeamortizedHammerSlide<AggrFun, type> hammerslide(windowSize);
+  std::deque<int> window;
+  int idx = 0;
+  bool isEqual = true;
+  while (idx < (int)input.size() && isEqual) {
+    // insert up to the window size, then evict a random number of tuples
+    int numOfVals = std::min(dist(mt), std::min(windowSize - (int)window.size(),
+                                                (int)input.size() - idx));
+    if (isBulk) {
+      hammerslide.insert(input.data(), idx, idx + numOfVals);
+    } else {
+      for (int i = idx; i < idx + numOfVals; i++) {
+        hammerslide.insert(input[i]);
+      }
+    }
+    window.insert(window.end(), input.begin() + idx, input.begin() + idx + numOfVals);
+    idx += numOfVals;
+
+    int numOfItems = std::min(dist(mt) / 2, (int)window.size());
+    for (int i = 0; i < numOfItems; i++) {
+      hammerslide.evict();
+      window.pop_front();
+      auto expected = op.identity;
+      for (auto v : window) {
+        expected = op.combine(expected, op.lift(v));
+      }
+      isEqual = isEqual && (hammerslide.query() == op.lower(expected));
+    }
+  }
+  CHECK(isEqual);
+}
+
+TEST_CASE("DeamortizedHammerSlide testing", "[deamortized]") {
+  SECTION("simple operations") {
+    DeamortizedHammerSlide<Sum<int, int, int>, SUM> hammerslide(4);
+    CHECK(hammerslide.query() == 0);
+    hammerslide.insert(42);
+    CHECK(hammerslide.query() == 42);
+    hammerslide.insert(1);
+    hammerslide.insert(5);
+    hammerslide.insert(2);
+    CHECK(hammerslide.query() == 50);
+    hammerslide.evict();
+    CHECK(hammerslide.query() == 8);
+    hammerslide.insert(10);
+    CHECK(hammerslide.query() == 18);
+    hammerslide.evict(3);
+    CHECK(hammerslide.query() == 10);
+    hammerslide.evict();
+    CHECK_THROWS(hammerslide.evict());
+  }
+
+  SECTION("random operations") {
+    check_random_operations<Sum<int, int, int>, SUM>(100, false);
+    check_random_operations<Sum<int, int, int>, SUM>(1024, true);
+    check_random_operations<Min<int, int, int>, MIN>(100, true);
+    check_random_operations<Min<int, int, int>, MIN>(1024, false);
+  }
+}
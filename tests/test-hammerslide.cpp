@@ -8,6 +8,7 @@
 #include "AggregationFunctions.hpp"
 #include "HammerSlide.hpp"
 #include "SystemConf.h"
+#include "test-utils.hpp"
 
 TEST_CASE("HammerSlide simple testing", "[operations]") {
   SECTION("SUM operations") {
@@ -302,4 +303,260 @@ TEST_CASE("HammerSlide test both versions", "[operations]") {
     bool equal = std::equal(simdRes.begin(), simdRes.end(), simpleRes.begin());
     CHECK(equal == true);
   }
-}
\ No newline at end of file
+}
+
+template <typename AggrFun, AggregationType type>
+static void check_prepare(int windowSize, int windowSlide, int maxBudget) {
+  auto input = random_input(32 * 1024);
+  HammerSlide<AggrFun, type> hammerslide(windowSize, windowSlide);
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> budget(0, maxBudget);
+
+  // prepare the next front stack at random points, including the middle of a slide
+  std::vector<typename AggrFun::Out> res;
+  int idx = 0;
+  for (; idx < windowSize; idx++) {
+    hammerslide.insert(input[idx]);
+    if (budget(mt) == 0) hammerslide.prepare(budget(mt));
+  }
+  while (true) {
+    res.push_back(hammerslide.query());
+    if (idx + windowSlide > (int)input.size()) break;
+    for (int n = windowSlide; n > 0;) {
+      if (hammerslide.m_ostackSize == 0) hammerslide.swap();
+      int k = std::min(n, hammerslide.m_ostackSize);
+      hammerslide.evict(k);
+      n -= k;
+    }
+    for (int i = 0; i < windowSlide; i++, idx++) {
+      hammerslide.insert(input[idx]);
+      if (i == windowSlide / 2) hammerslide.prepare(budget(mt));
+    }
+    hammerslide.prepare(budget(mt));
+  }
+
+  CHECK(res == naive_windows<AggrFun>(input, windowSize, windowSlide));
+}
+
+TEST_CASE("HammerSlide incremental swap", "[operations]") {
+  SECTION("SUM operations") {
+    check_prepare<Sum<int, int, int>, SUM>(1024, 64, 128);
+    check_prepare<Sum<int, int, int>, SUM>(100, 10, 4);
+  }
+
+  SECTION("MIN operations") {
+    check_prepare<Min<int, int, int>, MIN>(1024, 64, 16);
+    check_prepare<Min<int, int, int>, MIN>(96, 32, 1024);
+  }
+}
+
+template <typename AggrFun, AggregationType type>
+static void check_query_range(int windowSize, int windowSlide, bool isSIMD) {
+  auto input = random_input(16 * 1024);
+  HammerSlide<AggrFun, type> hammerslide(windowSize, windowSlide);
+  AggrFun op;
+  std::mt19937 mt(42);
+
+  // the aggregate of input[start, end) computed from scratch
+  auto naive = [&](int start, int end) {
+    auto value = op.identity;
+    for (int i = start; i < end; i++) value = op.combine(value, op.lift(input[i]));
+    return op.lower(value);
+  };
+
+  hammerslide.insert(input.data(), 0, windowSize);
+  int idx = windowSize;
+  while (idx + windowSlide <= (int)input.size()) {
+    CHECK(hammerslide.query(isSIMD) == naive(idx - windowSize, idx));
+    for (int k : {1, windowSlide / 2, windowSlide, 2 * windowSlide + 1, windowSize}) {
+      CHECK(hammerslide.query_range(k) == naive(idx - k, idx));
+    }
+    std::uniform_int_distribution<int> dist(0, windowSize);
+    int from = dist(mt), to = dist(mt);
+    if (from > to) std::swap(from, to);
+    if (from < to) {
+      CHECK(hammerslide.query_range(from, to) ==
+            naive(idx - windowSize + from, idx - windowSize + to));
+    }
+
+    hammerslide.evict(windowSlide);
+    // insert the slide in two steps, so that ranges also end within the back stack
+    hammerslide.insert_simple_range(input.data(), idx, idx + windowSlide / 2);
+    CHECK(hammerslide.query_range(windowSlide) ==
+          naive(idx + windowSlide / 2 - windowSlide, idx + windowSlide / 2));
+    hammerslide.insert_simple_range(input.data(), idx + windowSlide / 2, idx + windowSlide);
+    idx += windowSlide;
+  }
+  CHECK_THROWS(hammerslide.query_range(windowSize + 1));
+  CHECK_THROWS(hammerslide.query_range(0));
+}
+
+TEST_CASE("HammerSlide range queries", "[operations]") {
+  SECTION("SUM operations") {
+    check_query_range<Sum<int, int, int>, SUM>(1024, 64, true);
+    check_query_range<Sum<int, int, int>, SUM>(100, 10, false);
+  }
+
+  SECTION("MIN operations") {
+    check_query_range<Min<int, int, int>, MIN>(512, 32, true);
+    check_query_range<Min<int, int, int>, MIN>(96, 32, false);
+  }
+}
+
+template <typename AggrFun, AggregationType type>
+static void check_process(int windowSize, int windowSlide, int batchSize) {
+  auto input = random_input(16 * 1024);
+  HammerSlide<AggrFun, type> hammerslide(windowSize, windowSlide);
+  std::vector<typename AggrFun::Out> res(input.size() / windowSlide + 1);
+  size_t numOfResults = 0;
+  for (size_t start = 0; start < input.size(); start += batchSize) {
+    size_t n = std::min((size_t)batchSize, input.size() - start);
+    numOfResults += hammerslide.process(input.data() + start, n, res.data() + numOfResults);
+  }
+  res.resize(numOfResults);
+
+  CHECK(res == naive_windows<AggrFun>(input, windowSize, windowSlide));
+}
+
+TEST_CASE("HammerSlide batch processing", "[operations]") {
+  SECTION("SUM operations") {
+    check_process<Sum<int, int, int>, SUM>(1024, 64, 4096);
+    check_process<Sum<int, int, int>, SUM>(1024, 64, 100);
+    check_process<Sum<int, int, int>, SUM>(100, 30, 77);
+    check_process<Sum<int, int, int>, SUM>(8, 1, 3);
+  }
+
+  SECTION("MIN operations") {
+    check_process<Min<int, int, int>, MIN>(512, 32, 16 * 1024);
+    check_process<Min<int, int, int>, MIN>(96, 32, 1);
+  }
+}
+
+template <typename AggrFun, AggregationType type>
+static void check_parallel_swap(int windowSize, int windowSlide, int minSize) {
+  auto input = random_input(256 * 1024);
+  HammerSlide<AggrFun, type> hammerslide(windowSize, windowSlide);
+  hammerslide.set_parallel_swap(minSize);
+  std::vector<typename AggrFun::Out> res;
+  hammerslide.insert(input.data(), 0, windowSize);
+  for (int idx = windowSize;; idx += windowSlide) {
+    res.push_back(hammerslide.query());
+    if (idx == windowSize) {
+      // the parallel swap keeps the layout of the SIMD swap for aligned slides
+      bool isStrided = windowSlide >= 16 && windowSize % windowSlide == 0;
+      CHECK(hammerslide.m_ostackStride == (isStrided ? windowSlide : 1));
+    }
+    if (idx + windowSlide > (int)input.size()) break;
+    hammerslide.evict(windowSlide);
+    hammerslide.insert(input.data(), idx, idx + windowSlide);
+  }
+
+  CHECK(res == naive_windows<AggrFun>(input, windowSize, windowSlide));
+}
+
+TEST_CASE("HammerSlide parallel swap", "[operations]") {
+  SECTION("SUM operations") {
+    check_parallel_swap<Sum<int, int, int>, SUM>(64 * 1024, 4096, 1);
+    check_parallel_swap<Sum<int, int, int>, SUM>(96000, 3000, 50000);
+  }
+
+  SECTION("MIN operations") {
+    check_parallel_swap<Min<int, int, int>, MIN>(64 * 1024, 8192, 1);
+    check_parallel_swap<Min<int, int, int>, MIN>(42000, 7, 1);
+  }
+
+  SECTION("copies share the arena") {
+    HammerSlide<Sum<int, int, int>, SUM> hammerslide(64, 16);
+    hammerslide.set_parallel_swap(1);
+    auto input = random_input(64);
+    hammerslide.insert(input.data(), 0, 64);
+    HammerSlide<Sum<int, int, int>, SUM> copy = hammerslide;
+    CHECK(copy.m_swapArena == hammerslide.m_swapArena);
+    CHECK(copy.query() == naive_windows<Sum<int, int, int>>(input, 64, 16)[0]);
+    CHECK(hammerslide.query() == copy.query());
+  }
+}
+
+TEST_CASE("HammerSlide lookahead", "[operations]") {
+  auto input = random_input(16 * 1024);
+  const int windowSize = 1024, windowSlide = 32;
+  auto expected = naive_windows<Min<int, int, int>>(input, windowSize, windowSlide);
+
+  HammerSlide<Min<int, int, int>, MIN> hammerslide(windowSize, windowSlide);
+  std::vector<int> res(input.size() / windowSlide + 1);
+  // close the first window, so that the front stack covers the next slides
+  CHECK(hammerslide.process(input.data(), windowSize, res.data()) == 1);
+  CHECK(res[0] == expected[0]);
+
+  // all the pending answers of the front stack are available without changing the state
+  const int* batch = input.data() + windowSize;
+  int numOfResults = hammerslide.lookahead(batch, 100, res.data());
+  CHECK(numOfResults == (windowSize - windowSlide) / windowSlide);
+  for (int i = 0; i < numOfResults; i++) {
+    CHECK(res[i] == expected[i + 1]);
+  }
+  CHECK(hammerslide.lookahead(batch, 3, res.data()) == 3);
+  CHECK(hammerslide.m_capacity == (size_t)(windowSize - windowSlide));
+
+  // the scalar path gives the same answers
+  HammerSlide<Min<int, int, int>, MIN> scalar(windowSize, windowSlide);
+  std::vector<int> scalarRes(res.size());
+  scalar.insert_simple_range(input.data(), 0, windowSize);
+  scalar.query(false);
+  scalar.evict(windowSlide);
+  CHECK(scalar.lookahead(batch, 100, scalarRes.data(), false) == numOfResults);
+  for (int i = 0; i < numOfResults; i++) {
+    CHECK(scalarRes[i] == expected[i + 1]);
+  }
+}
+
+template <typename AggrFun, AggregationType type>
+static void check_retract(int windowSize, int windowSlide) {
+  auto input = random_input(16 * 1024);
+  HammerSlide<AggrFun, type> hammerslide(windowSize, windowSlide);
+  AggrFun op;
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> coin(0, 3);
+  std::uniform_int_distribution<int> offsets(0, windowSize - 1);
+
+  // the window contents, where retracted tuples are replaced by the identity
+  std::vector<typename AggrFun::Partial> window;
+  auto naive = [&](int from, int to) {
+    auto value = op.identity;
+    for (int i = from; i < to; i++) value = op.combine(value, window[i]);
+    return op.lower(value);
+  };
+
+  hammerslide.insert(input.data(), 0, windowSize);
+  for (int i = 0; i < windowSize; i++) window.push_back(op.lift(input[i]));
+  for (int idx = windowSize; idx + windowSlide <= (int)input.size(); idx += windowSlide) {
+    if (coin(mt) == 0) {
+      int offset = offsets(mt);
+      hammerslide.retract(offset);
+      window[offset] = op.identity;
+    } else if (coin(mt) == 0) {
+      int offset = offsets(mt);
+      hammerslide.update(offset, input[idx - offset]);
+      window[offset] = op.lift(input[idx - offset]);
+    }
+    CHECK(hammerslide.query() == naive(0, windowSize));
+    CHECK(hammerslide.query_range(windowSlide) == naive(windowSize - windowSlide, windowSize));
+
+    hammerslide.evict(windowSlide);
+    window.erase(window.begin(), window.begin() + windowSlide);
+    hammerslide.insert(input.data(), idx, idx + windowSlide);
+    for (int i = idx; i < idx + windowSlide; i++) window.push_back(op.lift(input[i]));
+  }
+  CHECK_THROWS(hammerslide.retract(windowSize));
+}
+
+TEST_CASE("HammerSlide retractions and updates", "[operations]") {
+  SECTION("SUM operations") {
+    check_retract<Sum<int, int, int>, SUM>(1024, 64);
+    check_retract<Sum<int, int, int>, SUM>(100, 10);
+  }
+
+  SECTION("MIN operations") {
+    check_retract<Min<int, int, int>, MIN>(512, 32);
+  }
+}
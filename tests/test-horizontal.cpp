@@ -0,0 +1,44 @@
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "HorizontalHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_horizontal(int windowSize, int windowSlide) {
+  const int lanes = HorizontalHammerSlide<AggrFun, type>::LANES;
+  const int numOfTuples = 2048;
+  auto input = random_input(numOfTuples * lanes);
+
+  // tuple i of lane l is input[i * lanes + l]
+  HorizontalHammerSlide<AggrFun, type> window(windowSize, windowSlide);
+  std::vector<std::vector<int>> res(lanes);
+  int results[lanes];
+  for (int i = 0; i < numOfTuples; i++) {
+    window.insert(&input[i * lanes]);
+    if (window.m_capacity == windowSize) {
+      window.query(results);
+      for (int l = 0; l < lanes; l++) res[l].push_back(results[l]);
+      window.evict(windowSlide);
+    }
+  }
+
+  for (int l = 0; l < lanes; l++) {
+    InputVector stream;
+    for (int i = 0; i < numOfTuples; i++) stream.push_back(input[i * lanes + l]);
+    CHECK(res[l] == naive_windows<AggrFun>(stream, windowSize, windowSlide));
+  }
+}
+
+TEST_CASE("HorizontalHammerSlide testing", "[horizontal]") {
+  SECTION("SUM operations") {
+    check_horizontal<Sum<int, int, int>, SUM>(16, 4);
+    check_horizontal<Sum<int, int, int>, SUM>(10, 3);
+  }
+
+  SECTION("MIN operations") {
+    check_horizontal<Min<int, int, int>, MIN>(8, 1);
+    check_horizontal<Min<int, int, int>, MIN>(64, 64);
+  }
+}
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <type_traits>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "InvertibleHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+static_assert(has_inverse_combine<Sum<int, int, int>>::value, "Sum is invertible");
+static_assert(has_inverse_combine<Mean<int>>::value, "Mean is invertible");
+static_assert(!has_inverse_combine<Min<int, int, int>>::value, "Min is not invertible");
+static_assert(std::is_same<SlidingAggregator<Sum<int, int, int>, SUM>,
+                           InvertibleHammerSlide<Sum<int, int, int>, SUM>>::value,
+              "Sum selects the Subtract-on-Evict aggregator");
+static_assert(std::is_same<SlidingAggregator<Min<int, int, int>, MIN>,
+                           HammerSlide<Min<int, int, int>, MIN>>::value,
+              "Min selects HammerSlide");
+
+template <typename AggrFun, AggregationType type>
+static void check_invertible(int windowSize, int windowSlide) {
+  auto input = random_input(16 * 1024);
+
+  InvertibleHammerSlide<AggrFun, type> window(windowSize, windowSlide);
+  std::vector<typename AggrFun::Out> res;
+  window.insert(input.data(), 0, windowSize);
+  res.push_back(window.query());
+  for (int idx = windowSize; idx + windowSlide <= (int)input.size(); idx += windowSlide) {
+    window.evict(windowSlide);
+    window.insert(input.data(), idx, idx + windowSlide);
+    res.push_back(window.query());
+  }
+
+  CHECK(res == naive_windows<AggrFun>(input, windowSize, windowSlide));
+}
+
+TEST_CASE("InvertibleHammerSlide testing", "[invertible]") {
+  SECTION("SUM operations") {
+    check_invertible<Sum<int, int, int>, SUM>(1024, 64);
+    check_invertible<Sum<int, int, int>, SUM>(100, 30);
+    check_invertible<Sum<int, int, int>, SUM>(8, 1);
+  }
+
+  SECTION("AVG operations") {
+    check_invertible<Mean<int>, AVG>(1024, 64);
+    check_invertible<Mean<int>, AVG>(100, 30);
+  }
+
+  SECTION("single tuple operations") {
+    SlidingAggregator<Sum<int, int, int>, SUM> window(4);
+    window.insert(42);
+    window.insert(1);
+    window.insert(5);
+    window.insert(2);
+    CHECK(window.query() == 50);
+    window.evict();
+    CHECK(window.query() == 8);
+    window.insert(10);
+    window.evict(3);
+    CHECK(window.query() == 10);
+    window.reset();
+    window.insert(7);
+    CHECK(window.query() == 7);
+  }
+}
@@ -0,0 +1,74 @@
+#include <map>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "KeyedHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_keyed(int windowSize, int windowSlide, int numOfKeys, int batchSize,
+                        bool grouped = false) {
+  auto input = random_input(32 * 1024);
+  auto keys = random_input(input.size(), numOfKeys);
+
+  KeyedHammerSlide<AggrFun, type> window(windowSize, windowSlide, 4);
+  // prefetch even though the states fit in the cache
+  window.m_cacheSize = 0;
+  std::vector<long> keyBatch(batchSize);
+  std::vector<long> resultKeys(batchSize);
+  std::vector<typename AggrFun::Out> results(batchSize);
+  std::map<long, std::vector<typename AggrFun::Out>> res;
+  for (int start = 0; start < (int)input.size(); start += batchSize) {
+    int n = std::min(batchSize, (int)input.size() - start);
+    for (int i = 0; i < n; i++) keyBatch[i] = -keys[start + i];
+    int numOfResults =
+        grouped ? window.insert_grouped(keyBatch.data(), input.data() + start, n,
+                                        resultKeys.data(), results.data())
+                : window.insert(keyBatch.data(), input.data() + start, n, resultKeys.data(),
+                                results.data());
+    for (int i = 0; i < numOfResults; i++) res[resultKeys[i]].push_back(results[i]);
+  }
+
+  // every key is a separate count-based window over its own tuples
+  std::map<long, InputVector> streams;
+  for (size_t i = 0; i < input.size(); i++) streams[-keys[i]].push_back(input[i]);
+  CHECK(window.m_numOfKeys == streams.size());
+  CHECK(sizeof(typename KeyedHammerSlide<AggrFun, type>::KeyState) <= 64);
+  for (auto& stream : streams) {
+    CHECK(res[stream.first] == naive_windows<AggrFun>(stream.second, windowSize, windowSlide));
+  }
+}
+
+TEST_CASE("KeyedHammerSlide testing", "[keyed]") {
+  SECTION("SUM operations") {
+    check_keyed<Sum<int, int, int>, SUM>(64, 16, 100, 1000);
+    check_keyed<Sum<int, int, int>, SUM>(8, 8, 1000, 7);
+  }
+
+  SECTION("MIN operations") {
+    check_keyed<Min<int, int, int>, MIN>(30, 3, 50, 128);
+  }
+
+  SECTION("grouped insertion") {
+    // groups with repeated keys, and new keys that make the table grow within a group
+    check_keyed<Sum<int, int, int>, SUM>(64, 16, 100, 1000, true);
+    check_keyed<Sum<int, int, int>, SUM>(8, 2, 3, 13, true);
+    check_keyed<Min<int, int, int>, MIN>(30, 3, 5000, 1, true);
+  }
+
+  SECTION("single key") {
+    KeyedHammerSlide<Sum<int, int, int>, SUM> window(4, 2);
+    long keys[] = {7, 7, 7, 7, 7, 7};
+    int vals[] = {1, 2, 3, 4, 5, 6};
+    long resultKeys[6];
+    int results[6];
+    CHECK(window.insert(keys, vals, 5, resultKeys, results) == 1);
+    CHECK(results[0] == 10);
+    CHECK(window.query(7) == 12);
+    CHECK(window.insert(keys, vals + 5, 1, resultKeys, results) == 1);
+    CHECK(results[0] == 18);
+    CHECK_THROWS(window.query(8));
+  }
+}
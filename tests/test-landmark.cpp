@@ -0,0 +1,65 @@
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "LandmarkWindow.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_landmark(int windowSlide, int batchSize, int landmarkEvery) {
+  auto input = random_input(16 * 1024);
+
+  LandmarkWindow<AggrFun, type> window(windowSlide);
+  std::vector<typename AggrFun::Out> res(input.size() / windowSlide + 1);
+  int numOfResults = 0;
+  for (int start = 0; start < (int)input.size(); start += landmarkEvery) {
+    window.landmark();
+    int segmentEnd = std::min(start + landmarkEvery, (int)input.size());
+    for (int pos = start; pos < segmentEnd; pos += batchSize) {
+      int end = std::min(pos + batchSize, segmentEnd);
+      numOfResults += window.process(input.data(), pos, end, res.data() + numOfResults);
+    }
+  }
+  res.resize(numOfResults);
+
+  AggrFun op;
+  std::vector<typename AggrFun::Out> expected;
+  for (int start = 0; start < (int)input.size(); start += landmarkEvery) {
+    auto value = op.identity;
+    int segmentEnd = std::min(start + landmarkEvery, (int)input.size());
+    for (int i = start; i < segmentEnd; i++) {
+      value = op.combine(value, op.lift(input[i]));
+      if ((i - start + 1) % windowSlide == 0) {
+        expected.push_back(op.lower(value));
+      }
+    }
+  }
+
+  CHECK(res == expected);
+}
+
+TEST_CASE("LandmarkWindow testing", "[landmark]") {
+  SECTION("SUM operations") {
+    check_landmark<Sum<int, int, int>, SUM>(64, 1000, 4096);
+    check_landmark<Sum<int, int, int>, SUM>(10, 64, 1000);
+  }
+
+  SECTION("MIN operations") {
+    check_landmark<Min<int, int, int>, MIN>(256, 4096, 8192);
+    check_landmark<Min<int, int, int>, MIN>(7, 13, 777);
+  }
+
+  SECTION("single tuples") {
+    LandmarkWindow<Sum<int, int, int>, SUM> window(2);
+    int res = 0;
+    CHECK(window.insert(1, res) == false);
+    CHECK(window.insert(2, res) == true);
+    CHECK(res == 3);
+    CHECK(window.insert(3, res) == false);
+    CHECK(window.query() == 6);
+    CHECK(window.insert(4, res) == true);
+    CHECK(res == 10);
+    window.landmark();
+    CHECK(window.query() == 0);
+  }
+}
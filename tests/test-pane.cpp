@@ -0,0 +1,60 @@
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "PaneHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_panes(int windowSize, int windowSlide, int batchSize) {
+  auto input = random_input(16 * 1024);
+
+  PaneHammerSlide<AggrFun, type> window(windowSize, windowSlide);
+  std::vector<typename AggrFun::Out> res;
+  int idx = 0;
+  while (idx + windowSlide <= (int)input.size()) {
+    if (window.m_capacity == windowSize) {
+      res.push_back(window.query());
+      window.evict(windowSlide);
+    }
+    // insert the next slide in batches that do not respect the pane boundaries
+    for (int end = idx + windowSlide; idx < end;) {
+      int next = std::min(idx + batchSize, end);
+      window.insert(input.data(), idx, next);
+      idx = next;
+    }
+  }
+  res.push_back(window.query());
+
+  CHECK(window.m_panes.m_queue.m_size == (size_t)(windowSize / windowSlide));
+  CHECK(res == naive_windows<AggrFun>(input, windowSize, windowSlide));
+}
+
+TEST_CASE("PaneHammerSlide testing", "[pane]") {
+  SECTION("SUM operations") {
+    check_panes<Sum<int, int, int>, SUM>(1024, 64, 1000);
+    check_panes<Sum<int, int, int>, SUM>(1024, 64, 7);
+    check_panes<Sum<int, int, int>, SUM>(8, 1, 1);
+  }
+
+  SECTION("MIN operations") {
+    check_panes<Min<int, int, int>, MIN>(1024, 256, 100);
+    check_panes<Min<int, int, int>, MIN>(90, 30, 30);
+  }
+
+  SECTION("open pane and invalid evictions") {
+    PaneHammerSlide<Sum<int, int, int>, SUM> window(4, 2);
+    window.insert(1);
+    CHECK(window.query() == 1);
+    window.insert(2);
+    window.insert(3);
+    CHECK(window.query() == 6);
+    CHECK_THROWS(window.evict(1));
+    CHECK_THROWS(window.evict(4));
+    window.evict(2);
+    CHECK(window.query() == 3);
+    window.reset();
+    CHECK(window.query() == 0);
+    CHECK_THROWS(PaneHammerSlide<Sum<int, int, int>, SUM>(10, 4));
+  }
+}
@@ -0,0 +1,56 @@
+#include <map>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "PartitionedHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_partitioned(int windowSize, int windowSlide, int numOfWorkers) {
+  auto input = random_input(64 * 1024);
+  auto randomKeys = random_input(input.size(), 5000);
+  std::vector<long> keys(randomKeys.begin(), randomKeys.end());
+
+  PartitionedHammerSlide<AggrFun, type> engine(windowSize, windowSlide, numOfWorkers, false);
+  KeyedHammerSlide<AggrFun, type> reference(windowSize, windowSlide);
+  std::vector<long> resultKeys(input.size());
+  std::vector<typename AggrFun::Out> results(input.size());
+  int numOfResults = reference.insert(keys.data(), input.data(), (int)input.size(),
+                                      resultKeys.data(), results.data());
+  std::map<long, std::vector<typename AggrFun::Out>> expected, res;
+  for (int i = 0; i < numOfResults; i++) expected[resultKeys[i]].push_back(results[i]);
+
+  for (int start = 0; start < (int)input.size(); start += 1000) {
+    int n = std::min(1000, (int)input.size() - start);
+    engine.insert(keys.data() + start, input.data() + start, n);
+  }
+  engine.flush();
+  for (auto& worker : engine.m_workers) {
+    for (size_t i = 0; i < worker->m_results.size(); i++) {
+      res[worker->m_resultKeys[i]].push_back(worker->m_results[i]);
+    }
+  }
+  CHECK(res == expected);
+
+  // every key belongs to one worker
+  size_t numOfKeys = 0;
+  for (auto& worker : engine.m_workers) numOfKeys += worker->m_window.m_numOfKeys;
+  CHECK(numOfKeys == reference.m_numOfKeys);
+
+  engine.clear_results();
+  engine.flush();
+  for (auto& worker : engine.m_workers) CHECK(worker->m_results.empty());
+}
+
+TEST_CASE("PartitionedHammerSlide testing", "[partitioned]") {
+  SECTION("SUM operations") {
+    check_partitioned<Sum<int, int, int>, SUM>(8, 2, 3);
+    check_partitioned<Sum<int, int, int>, SUM>(16, 16, 1);
+  }
+
+  SECTION("MIN operations") {
+    check_partitioned<Min<int, int, int>, MIN>(12, 4, 4);
+  }
+}
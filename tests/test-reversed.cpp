@@ -0,0 +1,61 @@
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "ReversedHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_reversed(int windowSize, int windowSlide, bool isSIMD) {
+  auto input = random_input(16 * 1024);
+
+  ReversedHammerSlide<AggrFun, type> window(windowSize, windowSlide);
+  std::vector<typename AggrFun::Out> res;
+  window.insert(input.data(), 0, windowSize);
+  int idx = windowSize;
+  while (true) {
+    res.push_back(window.query(isSIMD));
+    if (idx + windowSlide > (int)input.size()) break;
+    window.evict(windowSlide);
+    if (isSIMD) {
+      window.insert(input.data(), idx, idx + windowSlide);
+    } else {
+      for (int i = idx; i < idx + windowSlide; i++) window.insert(input[i]);
+    }
+    idx += windowSlide;
+  }
+
+  CHECK(res == naive_windows<AggrFun>(input, windowSize, windowSlide));
+}
+
+TEST_CASE("ReversedHammerSlide testing", "[reversed]") {
+  SECTION("SUM operations") {
+    check_reversed<Sum<int, int, int>, SUM>(1024, 64, true);
+    check_reversed<Sum<int, int, int>, SUM>(1024, 64, false);
+    check_reversed<Sum<int, int, int>, SUM>(100, 20, true);
+  }
+
+  SECTION("MIN operations") {
+    check_reversed<Min<int, int, int>, MIN>(1000, 40, true);
+    check_reversed<Min<int, int, int>, MIN>(96, 32, false);
+  }
+
+  SECTION("single tuple operations") {
+    ReversedHammerSlide<Sum<int, int, int>, SUM> window(4, 1);
+    window.insert(42);
+    CHECK(window.query() == 42);
+    window.insert(1);
+    window.insert(5);
+    window.insert(2);
+    CHECK(window.query() == 50);
+    window.evict();
+    CHECK(window.query() == 8);
+    window.insert(10);
+    window.evict(3);
+    CHECK(window.query() == 10);
+    window.insert(1);
+    window.insert(2);
+    window.insert(3);
+    CHECK_THROWS(window.insert(4));
+  }
+}
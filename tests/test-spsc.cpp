@@ -0,0 +1,72 @@
+#include <thread>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "HammerSlide.hpp"
+#include "SPSCQueue.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+TEST_CASE("SPSCQueue testing", "[spsc]") {
+  SECTION("single thread") {
+    SPSCQueue<int> queue(3, 10);
+    REQUIRE(queue.m_numOfBatches == 4);
+    REQUIRE(queue.m_stride == 16);
+    for (int b = 0; b < 4; b++) {
+      int* slot = queue.acquire();
+      CHECK((uintptr_t)slot % 64 == 0);
+      for (int i = 0; i <= b; i++) slot[i] = 10 * b + i;
+      queue.publish(b + 1);
+    }
+    for (int b = 0; b < 4; b++) {
+      int size;
+      int* slot = queue.front(size);
+      REQUIRE(size == b + 1);
+      for (int i = 0; i < size; i++) CHECK(slot[i] == 10 * b + i);
+      queue.release();
+    }
+    queue.close();
+    int size;
+    CHECK(queue.front(size) == nullptr);
+    CHECK_THROWS(queue.publish(11));
+  }
+
+  SECTION("zero-copy insert from another thread") {
+    const int windowSize = 512;
+    const int windowSlide = 64;
+    auto input = random_input(200 * windowSlide);
+
+    HammerSlide<Sum<int, int, int>, SUM> reference(windowSize, windowSlide);
+    std::vector<int> expected;
+    reference.insert(input.data(), 0, windowSize);
+    for (int idx = windowSize; idx < (int)input.size(); idx += windowSlide) {
+      expected.push_back(reference.query());
+      reference.evict(windowSlide);
+      reference.insert(input.data(), idx, idx + windowSlide);
+    }
+
+    SPSCQueue<int> queue(64, windowSlide);
+    std::thread producer([&] {
+      for (int idx = 0; idx < (int)input.size(); idx += windowSlide) {
+        int* slot = queue.acquire();
+        std::copy(input.begin() + idx, input.begin() + idx + windowSlide, slot);
+        queue.publish(windowSlide);
+      }
+      queue.close();
+    });
+
+    HammerSlide<Sum<int, int, int>, SUM> hammerslide(windowSize, windowSlide);
+    std::vector<int> results;
+    int size;
+    for (int* batch; (batch = queue.front(size)) != nullptr; queue.release()) {
+      if (hammerslide.m_capacity == windowSize) {
+        results.push_back(hammerslide.query());
+        hammerslide.evict(size);
+      }
+      hammerslide.insert(batch, 0, size);
+    }
+    producer.join();
+    CHECK(results == expected);
+  }
+}
@@ -0,0 +1,66 @@
+#include <memory>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "StaticHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type, int Size, int Slide>
+static void check_static(int batchSize) {
+  auto input = random_input(16 * 1024);
+
+  // the buffer lives inside the object, so keep it off the stack
+  auto window = std::make_unique<StaticHammerSlide<AggrFun, type, Size, Slide>>();
+  std::vector<typename AggrFun::Out> res;
+  int idx = 0;
+  while (idx + Slide <= (int)input.size()) {
+    if (window->m_capacity == Size) {
+      res.push_back(window->query());
+      window->evict();
+    }
+    for (int end = idx + Slide; idx < end;) {
+      int next = std::min(idx + batchSize, end);
+      if (next - idx == 1) {
+        window->insert(input[idx]);
+      } else {
+        window->insert(input.data(), idx, next);
+      }
+      idx = next;
+    }
+  }
+  res.push_back(window->query());
+
+  CHECK(res == naive_windows<AggrFun>(input, Size, Slide));
+}
+
+TEST_CASE("StaticHammerSlide testing", "[static]") {
+  SECTION("SUM operations") {
+    check_static<Sum<int, int, int>, SUM, 1024, 64>(64);
+    check_static<Sum<int, int, int>, SUM, 1024, 64>(13);
+    check_static<Sum<int, int, int>, SUM, 100, 10>(1);
+  }
+
+  SECTION("MIN operations") {
+    check_static<Min<int, int, int>, MIN, 512, 32>(100);
+    check_static<Min<int, int, int>, MIN, 96, 32>(7);
+  }
+
+  SECTION("partial panes and invalid evictions") {
+    StaticHammerSlide<Sum<int, int, int>, SUM, 4, 2> window;
+    window.insert(1);
+    CHECK(window.query() == 1);
+    window.insert(2);
+    window.insert(3);
+    CHECK(window.query() == 6);
+    CHECK_THROWS(window.evict(1));
+    window.evict();
+    CHECK(window.query() == 3);
+    window.insert(4);
+    window.insert(5);
+    window.insert(6);
+    CHECK_THROWS(window.insert(7));
+    CHECK(window.query() == 18);
+  }
+}
@@ -0,0 +1,77 @@
+#include <map>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "StealingHammerSlide.hpp"
+#include "SystemConf.h"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_stealing(int windowSize, int windowSlide, int numOfThreads) {
+  auto input = random_input(64 * 1024);
+  // a skewed stream, where a third of the tuples belong to one key
+  auto randomKeys = random_input(input.size(), 3000);
+  std::vector<long> keys(randomKeys.begin(), randomKeys.end());
+  for (size_t i = 0; i < keys.size(); i += 3) keys[i] = 7;
+
+  StealingHammerSlide<AggrFun, type> engine(windowSize, windowSlide, numOfThreads);
+  KeyedHammerSlide<AggrFun, type> reference(windowSize, windowSlide);
+  std::vector<long> resultKeys(input.size());
+  std::vector<typename AggrFun::Out> results(input.size());
+  int numOfResults = reference.insert(keys.data(), input.data(), (int)input.size(),
+                                      resultKeys.data(), results.data());
+  std::map<long, std::vector<typename AggrFun::Out>> expected, res;
+  for (int i = 0; i < numOfResults; i++) expected[resultKeys[i]].push_back(results[i]);
+
+  for (int start = 0; start < (int)input.size(); start += 1000) {
+    int n = std::min(1000, (int)input.size() - start);
+    engine.insert(keys.data() + start, input.data() + start, n);
+    if (start % 16000 == 0) engine.flush();
+  }
+  engine.flush();
+  for (auto& shard : engine.m_shards) {
+    for (size_t i = 0; i < shard->m_results.size(); i++) {
+      res[shard->m_resultKeys[i]].push_back(shard->m_results[i]);
+    }
+  }
+  CHECK(res == expected);
+
+  // every key belongs to one shard
+  size_t numOfKeys = 0;
+  for (auto& shard : engine.m_shards) numOfKeys += shard->m_window.m_numOfKeys;
+  CHECK(numOfKeys == reference.m_numOfKeys);
+
+  engine.clear_results();
+  engine.flush();
+  for (auto& shard : engine.m_shards) CHECK(shard->m_results.empty());
+}
+
+TEST_CASE("StealingHammerSlide testing", "[stealing]") {
+  SECTION("SUM operations") {
+    check_stealing<Sum<int, int, int>, SUM>(8, 2, 3);
+    check_stealing<Sum<int, int, int>, SUM>(16, 16, 1);
+  }
+
+  SECTION("MIN operations") {
+    check_stealing<Min<int, int, int>, MIN>(12, 4, 4);
+  }
+
+  SECTION("bounded batches for a hot key") {
+    typedef StealingHammerSlide<Sum<int, int, int>, SUM> Engine;
+    auto input = random_input(256 * 1024);
+    std::vector<long> keys(input.size(), 7);
+    Engine engine(8, 2, 2);
+    for (int start = 0; start < (int)input.size(); start += 4096) {
+      engine.insert(keys.data() + start, input.data() + start, 4096);
+      for (auto& shard : engine.m_shards) {
+        CHECK(shard->m_batches.size() <= (size_t)Engine::BATCHES_PER_SHARD);
+      }
+    }
+    engine.flush();
+
+    size_t numOfResults = 0;
+    for (auto& shard : engine.m_shards) numOfResults += shard->m_results.size();
+    CHECK(numOfResults == (input.size() - 8) / 2 + 1);
+  }
+}
@@ -0,0 +1,105 @@
+#include <climits>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "SystemConf.h"
+#include "TimeWindowDriver.hpp"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_time_windows(long windowSize, long windowSlide, int batchSize,
+                               int watermarkEvery) {
+  auto input = random_input(8 * 1024);
+  std::vector<long> timestamps(input.size());
+  std::mt19937 mt(7);
+  std::uniform_int_distribution<int> dist(0, 3);
+  long ts = 3;
+  for (size_t i = 0; i < input.size(); i++) {
+    ts += (i % 1000 == 999) ? 10 * windowSize : dist(mt);  // leave some empty windows
+    timestamps[i] = ts;
+  }
+
+  TimeWindowDriver<AggrFun, type> driver(windowSize, windowSlide, 4 * 1024);
+  std::vector<std::pair<long, typename AggrFun::Out>> res;
+  for (int start = 0; start < (int)input.size(); start += batchSize) {
+    int end = std::min(start + batchSize, (int)input.size());
+    driver.insert(timestamps.data(), input.data(), start, end);
+    if ((start / batchSize) % watermarkEvery == 0) {
+      driver.watermark(timestamps[end - 1], res);
+    }
+  }
+  driver.watermark(LONG_MAX, res);
+
+  AggrFun op;
+  std::vector<std::pair<long, typename AggrFun::Out>> expected;
+  for (long windowStart = 0; windowStart <= timestamps.back(); windowStart += windowSlide) {
+    auto value = op.identity;
+    bool isEmpty = true;
+    for (size_t i = 0; i < input.size(); i++) {
+      if (timestamps[i] >= windowStart && timestamps[i] < windowStart + windowSize) {
+        value = op.combine(value, op.lift(input[i]));
+        isEmpty = false;
+      }
+    }
+    if (!isEmpty) {
+      expected.emplace_back(windowStart + windowSize, op.lower(value));
+    }
+  }
+
+  CHECK(res == expected);
+}
+
+TEST_CASE("TimeWindowDriver testing", "[time]") {
+  SECTION("SUM operations") {
+    check_time_windows<Sum<int, int, int>, SUM>(100, 20, 64, 1);
+    check_time_windows<Sum<int, int, int>, SUM>(100, 30, 100, 16);
+    check_time_windows<Sum<int, int, int>, SUM>(50, 50, 7, 3);
+  }
+
+  SECTION("MIN operations") {
+    check_time_windows<Min<int, int, int>, MIN>(100, 20, 500, 1);
+    check_time_windows<Min<int, int, int>, MIN>(64, 16, 1, 50);
+  }
+
+  SECTION("late tuples") {
+    TimeWindowDriver<Sum<int, int, int>, SUM> driver(10, 5, 16);
+    std::vector<std::pair<long, int>> res;
+    driver.insert(1, 1);
+    driver.insert(6, 2);
+    driver.insert(12, 3);
+    CHECK(driver.watermark(10, res) == 1);
+    CHECK(res[0] == std::make_pair(10L, 3));
+    CHECK_THROWS(driver.insert(9, 4));
+    CHECK(driver.watermark(15, res) == 1);
+    CHECK(res[1] == std::make_pair(15L, 5));
+  }
+
+  SECTION("capacity overflow after an eviction") {
+    TimeWindowDriver<Sum<int, int, int>, SUM> driver(10, 5, 4);
+    std::vector<std::pair<long, int>> res;
+    for (long ts : {1, 2, 6, 7}) driver.insert(ts, 1);
+    CHECK(driver.watermark(10, res) == 1);
+    CHECK(res[0] == std::make_pair(10L, 4));
+    // the window [5, 15) holds two tuples, so three more exceed the capacity
+    driver.insert(11, 1);
+    driver.insert(12, 1);
+    CHECK_THROWS(driver.insert(13, 1));
+  }
+
+  SECTION("rejected tuples leave no trace") {
+    TimeWindowDriver<Sum<int, int, int>, SUM> driver(10, 5, 2);
+    std::vector<std::pair<long, int>> res;
+    driver.insert(1, 1);
+    driver.insert(12, 2);
+    // the window [5, 15) would hold three pending tuples
+    std::vector<long> timestamps = {13, 14};
+    std::vector<int> vals = {3, 4};
+    CHECK_THROWS(driver.insert(timestamps.data(), vals.data(), 0, 2));
+    driver.insert(13, 3);
+    CHECK(driver.watermark(LONG_MAX, res) == 3);
+    CHECK(res[0] == std::make_pair(10L, 1));
+    CHECK(res[1] == std::make_pair(15L, 5));
+    CHECK(res[2] == std::make_pair(20L, 5));
+  }
+}
@@ -0,0 +1,137 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <numeric>
+#include <set>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "HammerSlide.hpp"
+#include "KeyedHammerSlide.hpp"
+#include "utils.h"
+
+TEST_CASE("Topology testing", "[topology]") {
+  SECTION("CPU lists") {
+    CHECK(parse_cpu_list("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+    CHECK(parse_cpu_list("5") == std::vector<int>{5});
+    CHECK(parse_cpu_list("").empty());
+  }
+
+  SECTION("two sockets with SMT") {
+    // CPU c is on socket c % 2, and c and c + 4 are the SMT siblings of a physical core
+    std::string root = "/tmp/hammerslide-topology-" + std::to_string(getpid()) + "/";
+    auto write = [](const std::string& path, const std::string& value) {
+      std::ofstream(path) << value << "\n";
+    };
+    mkdir(root.c_str(), 0755);
+    write(root + "online", "0-7");
+    for (int cpu = 0; cpu < 8; cpu++) {
+      std::string dir = root + "cpu" + std::to_string(cpu) + "/";
+      mkdir(dir.c_str(), 0755);
+      mkdir((dir + "topology").c_str(), 0755);
+      mkdir((dir + "cache").c_str(), 0755);
+      mkdir((dir + "cache/index0").c_str(), 0755);
+      mkdir((dir + "node" + std::to_string(cpu % 2)).c_str(), 0755);
+      write(dir + "topology/physical_package_id", std::to_string(cpu % 2));
+      write(dir + "topology/thread_siblings_list",
+            std::to_string(cpu % 4) + "," + std::to_string(cpu % 4 + 4));
+      write(dir + "cache/index0/level", "3");
+      write(dir + "cache/index0/shared_cpu_list", (cpu % 2 == 0) ? "0,2,4,6" : "1,3,5,7");
+      write(dir + "cache/index0/size", "32768K");
+    }
+    auto topology = discover_topology(root);
+    size_t cacheSize = last_level_cache_size(root);
+    std::system(("rm -rf " + root).c_str());
+
+    REQUIRE(topology.size() == 8);
+    CHECK(topology[5].m_socket == 1);
+    CHECK(topology[5].m_node == 1);
+    CHECK(topology[5].m_core == 1);
+    CHECK(topology[5].m_smt == 1);
+    CHECK(topology[5].m_l3 == 1);
+    CHECK(cacheSize == 32UL * 1024 * 1024);
+    CHECK(get_placement(SPREAD, topology) == std::vector<int>{0, 2, 1, 3, 4, 6, 5, 7});
+    CHECK(get_placement(COMPACT, topology) == std::vector<int>{0, 2, 4, 6, 1, 3, 5, 7});
+  }
+
+  SECTION("placement policies") {
+    auto& topology = get_topology();
+    REQUIRE(!topology.empty());
+    std::set<int> physicalCores;
+    for (auto& cpu : topology) physicalCores.insert(cpu.m_core);
+
+    for (auto policy : {SPREAD, COMPACT}) {
+      auto placement = get_placement(policy);
+      CHECK(placement.size() == topology.size());
+      CHECK(std::set<int>(placement.begin(), placement.end()).size() == placement.size());
+    }
+
+    // the spread placement uses every physical core before any SMT sibling
+    auto placement = get_placement(SPREAD);
+    std::set<int> firstCores;
+    for (size_t i = 0; i < physicalCores.size(); i++) {
+      for (auto& cpu : topology) {
+        if (cpu.m_cpu == placement[i]) firstCores.insert(cpu.m_core);
+      }
+    }
+    CHECK(firstCores == physicalCores);
+
+    // the compact placement fills the socket of the first CPU first
+    placement = get_placement(COMPACT);
+    auto socket = [&](int cpu) {
+      for (auto& info : topology) {
+        if (info.m_cpu == cpu) return info.m_socket;
+      }
+      return -1;
+    };
+    for (size_t i = 1; i < placement.size(); i++) {
+      CHECK(socket(placement[i - 1]) <= socket(placement[i]));
+    }
+  }
+
+  SECTION("NUMA placement") {
+    auto nodes = numa_nodes();
+    REQUIRE(!nodes.empty());
+    int node = current_numa_node();
+    CHECK(std::find(nodes.begin(), nodes.end(), node) != nodes.end());
+    CHECK_THROWS(bind_to_numa_node(nullptr, 4096, -1));
+
+    // the kernel may refuse NUMA policies, e.g. without NUMA support or in a container
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    void* page = mmap(nullptr, pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1, 0);
+    REQUIRE(page != MAP_FAILED);
+    bool isSupported = bind_to_numa_node(page, pageSize, node);
+    munmap(page, pageSize);
+    if (!isSupported) {
+      WARN("skipping the NUMA binding checks: the kernel refused to bind memory");
+      return;
+    }
+
+    HammerSlide<Sum<int, int, int>, SUM> hammerslide(1024 * 1024, 1024);
+    REQUIRE(hammerslide.bind_to_node(node));
+    CHECK(hammerslide.m_queue.m_arr.get_allocator().m_node == node);
+    CHECK(numa_node_of_address(hammerslide.m_queue.m_arr.data() + 512 * 1024) == node);
+    CHECK(numa_node_of_address(hammerslide.m_ostackVal.data() + 512 * 1024) == node);
+
+    // the buffers allocated later stay on the node, and the range tree is allocated lazily
+    hammerslide.insert(1);
+    CHECK(hammerslide.query_range(1) == 1);
+    CHECK(hammerslide.m_rangeTree.m_tree.get_allocator().m_node == node);
+    CHECK(numa_node_of_address(hammerslide.m_rangeTree.m_tree.data()) == node);
+
+    KeyedHammerSlide<Sum<int, int, int>, SUM> keyed(8, 2, 16);
+    REQUIRE(keyed.bind_to_node(node));
+    std::vector<long> keys(4096);
+    std::vector<int> vals(keys.size(), 1);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::vector<long> resultKeys(keys.size());
+    std::vector<int> results(keys.size());
+    keyed.insert(keys.data(), vals.data(), (int)keys.size(), resultKeys.data(), results.data());
+    CHECK(keyed.m_table.get_allocator().m_node == node);
+    CHECK(numa_node_of_address(keyed.m_table.data()) == node);
+    CHECK(numa_node_of_address(keyed.m_slab.data()) == node);
+  }
+}
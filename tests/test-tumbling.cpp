@@ -0,0 +1,46 @@
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "SystemConf.h"
+#include "TumblingWindow.hpp"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_tumbling(int windowSize, int batchSize) {
+  auto input = random_input(16 * 1024);
+
+  TumblingWindow<AggrFun, type> window(windowSize);
+  std::vector<typename AggrFun::Out> res(input.size() / windowSize + 1);
+  int numOfResults = 0;
+  for (int start = 0; start < (int)input.size(); start += batchSize) {
+    int end = std::min(start + batchSize, (int)input.size());
+    numOfResults += window.process(input.data(), start, end, res.data() + numOfResults);
+  }
+  res.resize(numOfResults);
+
+  CHECK(res == naive_windows<AggrFun>(input, windowSize, windowSize));
+}
+
+TEST_CASE("TumblingWindow testing", "[tumbling]") {
+  SECTION("SUM operations") {
+    check_tumbling<Sum<int, int, int>, SUM>(1024, 1000);
+    check_tumbling<Sum<int, int, int>, SUM>(100, 64);
+    check_tumbling<Sum<int, int, int>, SUM>(1, 3);
+  }
+
+  SECTION("MIN operations") {
+    check_tumbling<Min<int, int, int>, MIN>(1024, 4096);
+    check_tumbling<Min<int, int, int>, MIN>(7, 13);
+  }
+
+  SECTION("single tuples") {
+    TumblingWindow<Sum<int, int, int>, SUM> window(3);
+    int res = 0;
+    CHECK(window.insert(1, res) == false);
+    CHECK(window.insert(2, res) == false);
+    CHECK(window.query() == 3);
+    CHECK(window.insert(3, res) == true);
+    CHECK(res == 6);
+    CHECK(window.query() == 0);
+  }
+}
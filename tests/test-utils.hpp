@@ -0,0 +1,34 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include <tbb/cache_aligned_allocator.h>
+
+typedef std::vector<int, tbb::cache_aligned_allocator<int>> InputVector;
+
+static inline InputVector random_input(size_t size, int maxValue = 1024) {
+  InputVector input(size);
+  std::mt19937 mt(42);
+  std::uniform_int_distribution<int> dist(1, maxValue);
+  for (auto& i : input) {
+    i = dist(mt);
+  }
+  return input;
+}
+
+// recomputes every count-based window from scratch
+template <typename AggrFun>
+static std::vector<typename AggrFun::Out> naive_windows(const InputVector& input, int windowSize,
+                                                        int windowSlide) {
+  AggrFun op;
+  std::vector<typename AggrFun::Out> res;
+  for (size_t end = windowSize; end <= input.size(); end += windowSlide) {
+    auto value = op.identity;
+    for (size_t i = end - windowSize; i < end; i++) {
+      value = op.combine(value, op.lift(input[i]));
+    }
+    res.push_back(op.lower(value));
+  }
+  return res;
+}
@@ -0,0 +1,58 @@
+#include <algorithm>
+
+#include "catch.hpp"
+
+#include "AggregationFunctions.hpp"
+#include "SystemConf.h"
+#include "WindowDriver.hpp"
+#include "test-utils.hpp"
+
+template <typename AggrFun, AggregationType type>
+static void check_driver(int windowSize, int windowSlide, SlicingTechnique slicing, int batchSize) {
+  auto input = random_input(16 * 1024);
+
+  WindowDriver<AggrFun, type> driver(windowSize, windowSlide, slicing);
+  std::vector<typename AggrFun::Out> res(input.size() / windowSlide + 1);
+  int numOfResults = 0;
+  for (int start = 0; start < (int)input.size(); start += batchSize) {
+    int end = std::min(start + batchSize, (int)input.size());
+    numOfResults += driver.process(input.data(), start, end, res.data() + numOfResults);
+  }
+  res.resize(numOfResults);
+
+  CHECK(res == naive_windows<AggrFun>(input, windowSize, windowSlide));
+}
+
+TEST_CASE("WindowDriver testing", "[driver]") {
+  SECTION("SUM with panes") {
+    check_driver<Sum<int, int, int>, SUM>(1024, 64, PANES, 1000);
+    check_driver<Sum<int, int, int>, SUM>(1024, 64, PANES, 64);
+    check_driver<Sum<int, int, int>, SUM>(100, 30, PANES, 77);
+    check_driver<Sum<int, int, int>, SUM>(8, 8, PANES, 5);
+  }
+
+  SECTION("MIN with panes") {
+    check_driver<Min<int, int, int>, MIN>(1024, 64, PANES, 4096);
+    check_driver<Min<int, int, int>, MIN>(256, 32, PANES, 13);
+    check_driver<Min<int, int, int>, MIN>(10, 4, PANES, 3);
+  }
+
+  SECTION("SUM and MIN with pairs") {
+    check_driver<Sum<int, int, int>, SUM>(1024, 64, PAIRS, 512);
+    check_driver<Sum<int, int, int>, SUM>(100, 30, PAIRS, 77);
+    check_driver<Min<int, int, int>, MIN>(10, 4, PAIRS, 3);
+    check_driver<Min<int, int, int>, MIN>(512, 96, PAIRS, 1024);
+  }
+
+  SECTION("reset") {
+    WindowDriver<Sum<int, int, int>, SUM> driver(4, 2);
+    InputVector input{1, 2, 3, 4, 5, 6};
+    int res[4];
+    CHECK(driver.process(input.data(), 0, 6, res) == 2);
+    CHECK(res[0] == 10);
+    CHECK(res[1] == 18);
+    driver.reset();
+    CHECK(driver.process(input.data(), 2, 6, res) == 1);
+    CHECK(res[0] == 18);
+  }
+}
@@ -45,7 +45,7 @@ template <typename I, typename P, typename O>
 const typename Sum<I,P,O>::Partial Sum<I,P,O>::identity = P();
 
 template <>
-const typename Sum<int>::Partial Sum<int>::identity = 0;
+inline const typename Sum<int>::Partial Sum<int>::identity = 0;
 
 template <class _In, class _Partial=_In, class _Out=_In>
 class Max {
@@ -82,7 +82,7 @@ template <typename I, typename P, typename O>
 const typename Max<I,P,O>::Partial Max<I,P,O>::identity = P();
 
 template <>
-const typename Max<int>::Partial Max<int>::identity = std::numeric_limits<int>::min();
+inline const typename Max<int>::Partial Max<int>::identity = std::numeric_limits<int>::min();
 
 template <class _In, class _Partial=_In, class _Out=_In>
 class Min {
@@ -119,7 +119,7 @@ template <typename I, typename P, typename O>
 const typename Min<I,P,O>::Partial Min<I,P,O>::identity = P();
 
 template <>
-const typename Min<int>::Partial Min<int>::identity = std::numeric_limits<int>::max();
+inline const typename Min<int>::Partial Min<int>::identity = std::numeric_limits<int>::max();
 
 template <class _In>
 class Mean {
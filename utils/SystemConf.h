@@ -8,12 +8,19 @@ enum AggregationType { MIN, MAX, CNT, SUM, AVG };
 
 enum TimeGranularity { sec, msec, nsec };
 
+enum BenchmarkType { SINGLE, KEYED, PARTITIONED, SKEWED, PIPELINE, SWAP, NUMA };
+
+enum PlacementPolicy { SPREAD, COMPACT };
+
 static unsigned int WORKER_THREADS = 1;
 static unsigned int WINDOW_SIZE = 1024;
 static unsigned int WINDOW_SLIDE = 64;
 static unsigned int DURATION = 4000;
 static unsigned int INPUT_SIZE = 16 * 1024 * 1024;
+static unsigned int NUM_OF_KEYS = 100000;
 static AggregationType TYPE = MIN;
+static BenchmarkType BENCHMARK = SINGLE;
+static PlacementPolicy PLACEMENT = SPREAD;
 
 static inline void parseCLArgs(int argc, const char** argv) {
   int i, j;
@@ -30,6 +37,14 @@ static inline void parseCLArgs(int argc, const char** argv) {
                    "    Window slide int tuples\n"
                    "  --input <int>\n"
                    "    Input size in tuples\n"
+                   "  --keys <int>\n"
+                   "    Number of distinct keys of the keyed benchmarks\n"
+                   "  --workers <int>\n"
+                   "    Maximum number of worker threads\n"
+                   "  --bench <name>\n"
+                   "    Choose name from [single, keyed, partitioned, skewed, pipeline, swap, numa]\n"
+                   "  --placement <name>\n"
+                   "    Choose name from [spread, compact]\n"
                 //"  --type fun\n"
                 //"    Choose fun from [MIN, SUM]\n"
                 << std::endl;
@@ -47,6 +62,36 @@ static inline void parseCLArgs(int argc, const char** argv) {
       DURATION = std::atoi(argv[j]);
     } else if (strcmp(argv[i], ("--input")) == 0) {
       INPUT_SIZE = std::atoi(argv[j]);
+    } else if (strcmp(argv[i], ("--keys")) == 0) {
+      NUM_OF_KEYS = std::atoi(argv[j]);
+    } else if (strcmp(argv[i], ("--workers")) == 0) {
+      WORKER_THREADS = std::atoi(argv[j]);
+    } else if (strcmp(argv[i], ("--bench")) == 0) {
+      if (strcmp(argv[j], ("single")) == 0) {
+        BENCHMARK = SINGLE;
+      } else if (strcmp(argv[j], ("keyed")) == 0) {
+        BENCHMARK = KEYED;
+      } else if (strcmp(argv[j], ("partitioned")) == 0) {
+        BENCHMARK = PARTITIONED;
+      } else if (strcmp(argv[j], ("skewed")) == 0) {
+        BENCHMARK = SKEWED;
+      } else if (strcmp(argv[j], ("pipeline")) == 0) {
+        BENCHMARK = PIPELINE;
+      } else if (strcmp(argv[j], ("swap")) == 0) {
+        BENCHMARK = SWAP;
+      } else if (strcmp(argv[j], ("numa")) == 0) {
+        BENCHMARK = NUMA;
+      } else {
+        throw std::runtime_error("error: unknown benchmark");
+      }
+    } else if (strcmp(argv[i], ("--placement")) == 0) {
+      if (strcmp(argv[j], ("spread")) == 0) {
+        PLACEMENT = SPREAD;
+      } else if (strcmp(argv[j], ("compact")) == 0) {
+        PLACEMENT = COMPACT;
+      } else {
+        throw std::runtime_error("error: unknown placement policy");
+      }
     } else if (strcmp(argv[i], ("--type")) == 0) {
       if (strcmp(argv[j], ("MIN")) == 0) {
         TYPE = MIN;
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include <tbb/cache_aligned_allocator.h>
+#include "topology.h"
+
+/*
+ * NUMA placement through the raw mbind and get_mempolicy system calls, so that neither
+ * libnuma nor its headers are needed. The constants are the ones of <numaif.h>.
+ * */
+#if !defined(MPOL_BIND)
+#define MPOL_BIND 2
+#endif
+
+#if !defined(MPOL_MF_MOVE)
+#define MPOL_MF_MOVE (1 << 1)
+#endif
+
+#if !defined(MPOL_F_NODE)
+#define MPOL_F_NODE (1 << 0)
+#endif
+
+#if !defined(MPOL_F_ADDR)
+#define MPOL_F_ADDR (1 << 1)
+#endif
+
+// the largest node id that a node mask covers
+static const int MAX_NUMA_NODES = 1024;
+
+// the online NUMA nodes of the host
+static inline std::vector<int> numa_nodes() {
+  std::vector<int> nodes = parse_cpu_list(read_sysfs("/sys/devices/system/node/online"));
+  if (nodes.empty()) nodes.push_back(0);
+  return nodes;
+}
+
+static inline int numa_node_of_cpu(int cpu) {
+  for (auto& info : get_topology()) {
+    if (info.m_cpu == cpu) return info.m_node;
+  }
+  return 0;
+}
+
+// the NUMA node of the CPU that the calling thread runs on
+static inline int current_numa_node() {
+  int cpu = sched_getcpu();
+  return (cpu < 0) ? 0 : numa_node_of_cpu(cpu);
+}
+
+/*
+ * Binds the pages that lie entirely within [addr, addr + len) to a NUMA node and moves the
+ * pages that have already been touched. The pages at the edges may be shared with other
+ * objects and keep their placement. Returns false if the kernel refused, e.g. without NUMA
+ * support or inside a restricted container.
+ * */
+static inline bool bind_to_numa_node(const void* addr, size_t len, int node) {
+  if (node < 0 || node >= MAX_NUMA_NODES) {
+    throw std::runtime_error("error: invalid NUMA node");
+  }
+  const uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+  uintptr_t start = ((uintptr_t)addr + pageSize - 1) & ~(pageSize - 1);
+  uintptr_t end = ((uintptr_t)addr + len) & ~(pageSize - 1);
+  if (start >= end) {
+    return true;
+  }
+  unsigned long mask[MAX_NUMA_NODES / (8 * sizeof(unsigned long))] = {};
+  mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+  return syscall(SYS_mbind, start, end - start, MPOL_BIND, mask, MAX_NUMA_NODES,
+                 MPOL_MF_MOVE) == 0;
+}
+
+// the NUMA node of the page at addr, or -1 if it is unknown
+static inline int numa_node_of_address(const void* addr) {
+  int node = -1;
+  if (syscall(SYS_get_mempolicy, &node, nullptr, 0, addr, MPOL_F_NODE | MPOL_F_ADDR) != 0) {
+    return -1;
+  }
+  return node;
+}
+
+/*
+ * Allocates cache-aligned memory like tbb::cache_aligned_allocator, or, given a NUMA node,
+ * maps every allocation separately and binds it to the node before it is touched. A bound
+ * mapping shares no page with other objects, so its policy ends when it is unmapped instead
+ * of applying to later allocations of the heap. The allocator moves along with the memory of
+ * a container, so the buffers that a container grows into stay on the same node.
+ * */
+template <typename T>
+struct NumaAllocator {
+  typedef T value_type;
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  int m_node;  // -1 for the default policy
+
+  NumaAllocator() : m_node(-1) {}
+
+  explicit NumaAllocator(int node) : m_node(node) {
+    if (node < -1 || node >= MAX_NUMA_NODES) {
+      throw std::runtime_error("error: invalid NUMA node");
+    }
+  }
+
+  template <typename U>
+  NumaAllocator(const NumaAllocator<U>& other) : m_node(other.m_node) {}
+
+  inline T* allocate(size_t n) {
+    if (m_node < 0) {
+      return tbb::cache_aligned_allocator<T>().allocate(n);
+    }
+    size_t len = mapping_size(n);
+    void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    // if the kernel refuses, the memory is still usable with the default policy
+    bind_to_numa_node(addr, len, m_node);
+    return (T*)addr;
+  }
+
+  inline void deallocate(T* addr, size_t n) {
+    if (m_node < 0) {
+      tbb::cache_aligned_allocator<T>().deallocate(addr, n);
+    } else {
+      munmap(addr, mapping_size(n));
+    }
+  }
+
+  /* helper functions */
+  static inline size_t mapping_size(size_t n) {
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    return (n * sizeof(T) + pageSize - 1) / pageSize * pageSize;
+  }
+};
+
+template <typename T, typename U>
+inline bool operator==(const NumaAllocator<T>& a, const NumaAllocator<U>& b) {
+  return a.m_node == b.m_node;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const NumaAllocator<T>& a, const NumaAllocator<U>& b) {
+  return a.m_node != b.m_node;
+}
+
+/*
+ * Moves the contents of a vector to memory that is bound to a NUMA node, keeping its
+ * capacity. Returns false if the kernel refused to bind it.
+ * */
+template <typename T>
+static inline bool move_to_numa_node(std::vector<T, NumaAllocator<T>>& vals, int node) {
+  if (node < 0) {
+    throw std::runtime_error("error: invalid NUMA node");
+  }
+  std::vector<T, NumaAllocator<T>> moved{NumaAllocator<T>(node)};
+  moved.reserve(vals.capacity());
+  // the allocator ignores a refusal, so check the binding of the new mapping
+  bool bound = moved.capacity() == 0 ||
+               bind_to_numa_node(moved.data(),
+                                 NumaAllocator<T>::mapping_size(moved.capacity()), node);
+  moved.insert(moved.end(), vals.begin(), vals.end());
+  vals = std::move(moved);
+  return bound;
+}
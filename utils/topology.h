@@ -0,0 +1,158 @@
+#pragma once
+
+#include <dirent.h>
+#include <sched.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SystemConf.h"
+
+/*
+ * The topology of the CPUs that the process may run on, as reported by
+ * /sys/devices/system/cpu. Every CPU (i.e., hardware thread) belongs to a socket, a NUMA node,
+ * a physical core and an L3 cache, and is the smt-th hardware thread of its physical core.
+ * Without sysfs, every CPU is treated as a physical core of a single socket.
+ * */
+struct CpuInfo {
+  int m_cpu;
+  int m_socket;
+  int m_node;
+  int m_core;  // the first CPU of the physical core, since core ids repeat across sockets
+  int m_l3;    // the first CPU that shares the L3 cache, or -1 if unknown
+  int m_smt;
+};
+
+// parses a CPU list such as "0-3,8,10-11"
+static inline std::vector<int> parse_cpu_list(const std::string& list) {
+  std::vector<int> cpus;
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty() || range == "\n") continue;
+    size_t dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+static inline std::string read_sysfs(const std::string& path) {
+  std::ifstream file(path);
+  std::string value;
+  std::getline(file, value);
+  return value;
+}
+
+static inline std::vector<CpuInfo> discover_topology(
+    const std::string& root = "/sys/devices/system/cpu/") {
+  std::vector<int> online = parse_cpu_list(read_sysfs(root + "online"));
+  if (online.empty()) {
+    for (int cpu = 0; cpu < (int)std::thread::hardware_concurrency(); cpu++) {
+      online.push_back(cpu);
+    }
+  }
+
+  std::vector<CpuInfo> cpus;
+  for (int cpu : online) {
+    std::string dir = root + "cpu" + std::to_string(cpu) + "/";
+    CpuInfo info{cpu, 0, 0, cpu, -1, 0};
+    std::string socket = read_sysfs(dir + "topology/physical_package_id");
+    if (!socket.empty()) info.m_socket = std::stoi(socket);
+    // the directory of a CPU links to its NUMA node, e.g. node0
+    if (DIR* entries = opendir(dir.c_str())) {
+      while (dirent* entry = readdir(entries)) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(entry->d_name[4])) {
+          info.m_node = std::atoi(entry->d_name + 4);
+        }
+      }
+      closedir(entries);
+    }
+    std::vector<int> siblings = parse_cpu_list(read_sysfs(dir + "topology/thread_siblings_list"));
+    if (!siblings.empty()) {
+      info.m_core = siblings[0];
+      info.m_smt = (int)(std::find(siblings.begin(), siblings.end(), cpu) - siblings.begin());
+    }
+    for (int index = 0;; index++) {
+      std::string cache = dir + "cache/index" + std::to_string(index) + "/";
+      std::string level = read_sysfs(cache + "level");
+      if (level.empty()) break;
+      if (level == "3") {
+        std::vector<int> shared = parse_cpu_list(read_sysfs(cache + "shared_cpu_list"));
+        if (!shared.empty()) info.m_l3 = shared[0];
+      }
+    }
+    cpus.push_back(info);
+  }
+  return cpus;
+}
+
+// the size in bytes of the largest cache of the first CPU, e.g. 32768K, or 0 if it is unknown
+static inline size_t last_level_cache_size(const std::string& root = "/sys/devices/system/cpu/") {
+  size_t size = 0;
+  int maxLevel = 0;
+  for (int index = 0;; index++) {
+    std::string cache = root + "cpu0/cache/index" + std::to_string(index) + "/";
+    std::string level = read_sysfs(cache + "level");
+    if (level.empty()) break;
+    std::string value = read_sysfs(cache + "size");
+    if (value.empty() || std::stoi(level) < maxLevel) continue;
+    maxLevel = std::stoi(level);
+    size = std::stoul(value);
+    if (value.back() == 'K') size <<= 10;
+    if (value.back() == 'M') size <<= 20;
+  }
+  return size;
+}
+
+// only keeps the CPUs that the process may run on, e.g. inside a container
+static inline std::vector<CpuInfo> allowed_cpus(std::vector<CpuInfo> cpus) {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) == 0) {
+    auto isForbidden = [&](const CpuInfo& info) { return !CPU_ISSET(info.m_cpu, &allowed); };
+    cpus.erase(std::remove_if(cpus.begin(), cpus.end(), isForbidden), cpus.end());
+  }
+  if (cpus.empty()) {
+    cpus.push_back(CpuInfo{0, 0, 0, 0, 0, 0});
+  }
+  return cpus;
+}
+
+// discovered once, before any thread of the process is pinned
+static inline const std::vector<CpuInfo>& get_topology() {
+  static const std::vector<CpuInfo> topology = allowed_cpus(discover_topology());
+  return topology;
+}
+
+/*
+ * Orders the CPUs in which threads should be placed:
+ * - SPREAD gives every thread its own physical core, across all the sockets, before it uses
+ *   the SMT siblings.
+ * - COMPACT keeps the threads on the socket (and L3 cache) of the first one, using its SMT
+ *   siblings before it moves to the next socket, e.g. for the stages of a pipeline.
+ * */
+static inline std::vector<int> get_placement(PlacementPolicy policy,
+                                             std::vector<CpuInfo> cpus = get_topology()) {
+  std::stable_sort(cpus.begin(), cpus.end(), [policy](const CpuInfo& a, const CpuInfo& b) {
+    if (policy == SPREAD) {
+      if (a.m_smt != b.m_smt) return a.m_smt < b.m_smt;
+      if (a.m_socket != b.m_socket) return a.m_socket < b.m_socket;
+      if (a.m_l3 != b.m_l3) return a.m_l3 < b.m_l3;
+    } else {
+      if (a.m_socket != b.m_socket) return a.m_socket < b.m_socket;
+      if (a.m_l3 != b.m_l3) return a.m_l3 < b.m_l3;
+      if (a.m_smt != b.m_smt) return a.m_smt < b.m_smt;
+    }
+    return a.m_core < b.m_core;
+  });
+  std::vector<int> placement;
+  for (auto& cpu : cpus) placement.push_back(cpu.m_cpu);
+  return placement;
+}
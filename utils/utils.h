@@ -1,11 +1,15 @@
 #pragma once
 
+#include <pthread.h>
 #include <sys/time.h>
 #include <cstdlib>
 #include <iostream>
 #include <thread>
 #include <vector>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
 #include "atomic_ops.h"
+#include "topology.h"
 
 //#define DEBUG
 #undef DEBUG
@@ -127,16 +131,15 @@ static inline uint32_t pow2roundup(uint32_t x) {
   return x + 1;
 }
 
-// todo: set the cores programmatically
-static std::vector<int> cores{0,  2,  4,  6,  8,  10, 12, 14, 16, 18, 20, 22,
-                              24, 26, 28, 30, 32, 34, 1,  3,  5,  7,  9,  11,
-                              13, 15, 17, 19, 21, 23, 25, 27, 29, 31, 33, 35};
-
-static inline void set_cpu_manually(int core_id) {
-  if (core_id >= (int)std::thread::hardware_concurrency()) {
+// pins the calling thread to the core_id-th CPU of the placement policy
+static inline void set_cpu_manually(int core_id, PlacementPolicy policy = PLACEMENT) {
+  // the topology is discovered once, so is the placement of every policy
+  static const std::vector<int> placements[] = {get_placement(SPREAD), get_placement(COMPACT)};
+  const std::vector<int>& cores = placements[policy];
+  if (core_id >= (int)cores.size()) {
     std::cout << "warning: the core id exceeds the number of cores" << std::endl;
-    core_id = core_id % (int)std::thread::hardware_concurrency();
   }
+  core_id = cores[core_id % (int)cores.size()];
   pthread_t pid = pthread_self();
   cpu_set_t cpuset;
   CPU_ZERO(&cpuset);
@@ -151,6 +154,38 @@ static inline void set_cpu_manually(int core_id) {
   }
 }
 
+/*
+ * Pins the worker threads of a TBB arena with a placement policy: the worker in slot i of the
+ * arena runs on the i-th CPU of the policy, next to the thread that entered the arena in
+ * slot 0. Workers move between arenas, so their affinity is restored when they leave.
+ * */
+struct PinningObserver : public tbb::task_scheduler_observer {
+  PlacementPolicy m_policy;
+
+  PinningObserver(tbb::task_arena& arena, PlacementPolicy policy = PLACEMENT)
+      : tbb::task_scheduler_observer(arena), m_policy(policy) {
+    observe(true);
+  }
+
+  ~PinningObserver() { observe(false); }
+
+  void on_scheduler_entry(bool isWorker) override {
+    if (!isWorker) return;
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved_affinity());
+    set_cpu_manually(tbb::this_task_arena::current_thread_index(), m_policy);
+  }
+
+  void on_scheduler_exit(bool isWorker) override {
+    if (!isWorker) return;
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved_affinity());
+  }
+
+  static cpu_set_t& saved_affinity() {
+    static thread_local cpu_set_t affinity;
+    return affinity;
+  }
+};
+
 template <typename Integer, std::enable_if_t<std::is_integral<Integer>::value, bool> = true>
 static Integer getDefault() {
   return 0;